@@ -53,6 +53,11 @@ android {
         compose = true
     }
 
+    // JVM 单元测试中 android.util.Log 等桩方法返回默认值，不抛 "not mocked"
+    testOptions {
+        unitTests.isReturnDefaultValues = true
+    }
+
     externalNativeBuild {
         cmake {
             path = file("src/main/cpp/CMakeLists.txt")
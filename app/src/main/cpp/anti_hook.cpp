@@ -1,14 +1,19 @@
 #include <jni.h>
+#include <atomic>
+#include <mutex>
 #include <string>
 #include <dlfcn.h>
 #include <unistd.h>
 #include <android/log.h>
 
+#include "proc_utils.h"
+
 #define LOG_TAG "AntiHook"
 #define LOGW(...) __android_log_print(ANDROID_LOG_WARN, LOG_TAG, __VA_ARGS__)
 
-// 存储原始的 JNIEnv，用于验证调用来源
-static JavaVM* g_jvm = nullptr;
+// 存储原始的 JavaVM，用于验证调用来源；初始化只执行一次，之后只读
+static std::once_flag g_initOnce;
+static std::atomic<JavaVM*> g_jvm{nullptr};
 static jobject g_context = nullptr;
 
 /**
@@ -16,14 +21,15 @@ static jobject g_context = nullptr;
  * 防止其他应用通过 dlopen 加载我们的 .so 并直接调用
  */
 bool verifyCallerIntegrity(JNIEnv* env) {
-    if (env == nullptr || g_jvm == nullptr) {
+    JavaVM* ourVm = g_jvm.load(std::memory_order_acquire);
+    if (env == nullptr || ourVm == nullptr) {
         LOGW("Invalid environment - possible direct .so call");
         return false;
     }
 
     // 检查 JNIEnv 是否属于我们的 JavaVM
     JavaVM* vm = nullptr;
-    if (env->GetJavaVM(&vm) != JNI_OK || vm != g_jvm) {
+    if (env->GetJavaVM(&vm) != JNI_OK || vm != ourVm) {
         LOGW("JavaVM mismatch - possible hijacked call");
         return false;
     }
@@ -86,14 +92,11 @@ bool verifyCallerIntegrity(JNIEnv* env) {
  */
 bool verifyProcessIntegrity() {
     // 读取 /proc/self/cmdline 获取进程名
-    FILE* fp = fopen("/proc/self/cmdline", "r");
-    if (fp == nullptr) {
+    std::string cmdline;
+    if (!readFileFully("/proc/self/cmdline", cmdline)) {
         return false;
     }
-
-    char processName[256] = {0};
-    fgets(processName, sizeof(processName), fp);
-    fclose(fp);
+    const char* processName = cmdline.c_str();
 
     // 检查进程名是否匹配
     if (strstr(processName, "com.grtsinry43.environmentdetector") == nullptr) {
@@ -163,11 +166,27 @@ Java_com_grtsinry43_environmentdetector_security_NativeSecurityDetector_initAnti
         jclass clazz,
         jobject context) {
 
-    // 保存 JavaVM 和 Context
-    env->GetJavaVM(&g_jvm);
-    g_context = env->NewGlobalRef(context);
+    // 保存 JavaVM 和 Context；重复调用不再创建新的全局引用
+    std::call_once(g_initOnce, [env, context] {
+        JavaVM* vm = nullptr;
+        env->GetJavaVM(&vm);
+        g_context = env->NewGlobalRef(context);
+        g_jvm.store(vm, std::memory_order_release);
+        LOGW("Anti-hook protection initialized");
+    });
+}
 
-    LOGW("Anti-hook protection initialized");
+/**
+ * 库卸载时释放初始化时创建的全局引用
+ */
+extern "C"
+JNIEXPORT void JNICALL JNI_OnUnload(JavaVM* vm, void* reserved) {
+    JNIEnv* env = nullptr;
+    if (g_context != nullptr && vm->GetEnv(reinterpret_cast<void**>(&env), JNI_VERSION_1_6) == JNI_OK) {
+        env->DeleteGlobalRef(g_context);
+        g_context = nullptr;
+    }
+    g_jvm.store(nullptr, std::memory_order_release);
 }
 
 /**
@@ -0,0 +1,225 @@
+#include <jni.h>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <android/log.h>
+#include <sys/system_properties.h>
+
+#include "event_log.h"
+#include "module_index.h"
+#include "proc_snapshot.h"
+#include "proc_utils.h"
+
+#define LOG_TAG "ArtMethodScan"
+#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN, LOG_TAG, __VA_ARGS__)
+
+namespace {
+
+/**
+ * 各 API 级别的 ArtMethod 大小
+ * entry_point_from_quick_compiled_code_ 始终是 ptr_sized_fields_ 的最后一个字段，
+ * 所以入口偏移 = 大小 - 指针大小
+ */
+struct ArtMethodLayout {
+    int minApi;
+    uint32_t size64;
+    uint32_t size32;
+};
+
+const ArtMethodLayout kArtMethodLayouts[] = {
+        {31, 32, 24},   // S 起移除了 dex_code_item_offset_
+        {28, 40, 28},   // P-R
+        {26, 48, 32},   // O
+        {24, 56, 36}    // N
+};
+
+// declaring_class_ 之后紧跟 access_flags_
+constexpr size_t kAccessFlagsOffset = 4;
+constexpr uint32_t kAccNative = 0x0100;
+
+constexpr const char* kProbeClass = "com/grtsinry43/environmentdetector/security/ArtMethodProbe";
+
+/**
+ * 已解析并缓存的方法
+ */
+struct TrackedMethod {
+    uintptr_t artMethod;
+    uint32_t baselineFlags;
+};
+
+// 解析结果跨扫描复用；解析和遍历都在 g_trackedMutex 内
+std::mutex g_trackedMutex;
+std::vector<TrackedMethod> g_trackedMethods;
+size_t g_entryPointOffset = 0;
+jfieldID g_artMethodField = nullptr;
+bool g_artMethodFieldResolved = false;
+
+int deviceApiLevel() {
+    char value[PROP_VALUE_MAX] = {0};
+    __system_property_get("ro.build.version.sdk", value);
+    return atoi(value);
+}
+
+/**
+ * 反射对象 -> ArtMethod*
+ * 优先读 Executable.artMethod，可调试应用的 jmethodID 可能是不透明索引（最低位为 1）
+ */
+uintptr_t artMethodOf(JNIEnv* env, jobject executable) {
+    if (!g_artMethodFieldResolved) {
+        g_artMethodFieldResolved = true;
+        jclass executableClass = env->FindClass("java/lang/reflect/Executable");
+        if (executableClass != nullptr) {
+            g_artMethodField = env->GetFieldID(executableClass, "artMethod", "J");
+            env->DeleteLocalRef(executableClass);
+        }
+        if (env->ExceptionCheck()) {
+            env->ExceptionClear();
+            g_artMethodField = nullptr;
+        }
+    }
+
+    if (g_artMethodField != nullptr) {
+        return static_cast<uintptr_t>(env->GetLongField(executable, g_artMethodField));
+    }
+
+    auto id = reinterpret_cast<uintptr_t>(env->FromReflectedMethod(executable));
+    return (id & 1) != 0 ? 0 : id;
+}
+
+/**
+ * 通过探针类中两个相邻声明的静态方法实测 ArtMethod 大小，与版本表交叉验证
+ */
+size_t resolveEntryPointOffset(JNIEnv* env) {
+    int api = deviceApiLevel();
+    size_t expected = 0;
+    for (const ArtMethodLayout& layout : kArtMethodLayouts) {
+        if (api >= layout.minApi) {
+            expected = sizeof(void*) == 8 ? layout.size64 : layout.size32;
+            break;
+        }
+    }
+
+    size_t measured = 0;
+    jclass probeClass = env->FindClass(kProbeClass);
+    if (probeClass != nullptr) {
+        jmethodID first = env->GetStaticMethodID(probeClass, "first", "()V");
+        jmethodID second = env->GetStaticMethodID(probeClass, "second", "()V");
+        if (first != nullptr && second != nullptr) {
+            jobject firstMethod = env->ToReflectedMethod(probeClass, first, JNI_TRUE);
+            jobject secondMethod = env->ToReflectedMethod(probeClass, second, JNI_TRUE);
+            uintptr_t a = artMethodOf(env, firstMethod);
+            uintptr_t b = artMethodOf(env, secondMethod);
+            if (a != 0 && b > a) measured = b - a;
+            env->DeleteLocalRef(firstMethod);
+            env->DeleteLocalRef(secondMethod);
+        }
+        env->DeleteLocalRef(probeClass);
+    }
+    if (env->ExceptionCheck()) {
+        env->ExceptionClear();
+    }
+
+    if (measured != 0 && measured != expected) {
+        // ROM 可能修改过 ArtMethod，实测值更可信
+        LOGW("ArtMethod size mismatch: measured %zu, table %zu (api %d)", measured, expected, api);
+    }
+    size_t size = measured != 0 ? measured : expected;
+    return size > sizeof(void*) ? size - sizeof(void*) : 0;
+}
+
+void resolveMethods(JNIEnv* env, jobjectArray methods) {
+    g_entryPointOffset = resolveEntryPointOffset(env);
+    if (g_entryPointOffset == 0) {
+        return;
+    }
+
+    jsize count = env->GetArrayLength(methods);
+    g_trackedMethods.reserve(static_cast<size_t>(count));
+    for (jsize i = 0; i < count; i++) {
+        jobject method = env->GetObjectArrayElement(methods, i);
+        uintptr_t artMethod = method != nullptr ? artMethodOf(env, method) : 0;
+        if (artMethod != 0) {
+            uint32_t flags = *reinterpret_cast<const uint32_t*>(artMethod + kAccessFlagsOffset);
+            g_trackedMethods.push_back({artMethod, flags});
+        }
+        env->DeleteLocalRef(method);
+    }
+    LOGD("Tracking %zu ArtMethods, entry point offset %zu", g_trackedMethods.size(), g_entryPointOffset);
+}
+
+bool isTrustedEntryPoint(CodeOrigin origin) {
+    return origin == CodeOrigin::Runtime ||
+           origin == CodeOrigin::CompiledDex ||
+           origin == CodeOrigin::Jit;
+}
+
+int countSuspiciousMethods(const ModuleIndex& index, bool report) {
+    int suspicious = 0;
+    for (const TrackedMethod& method : g_trackedMethods) {
+        uintptr_t entryPoint = *reinterpret_cast<const uintptr_t*>(method.artMethod + g_entryPointOffset);
+        uint32_t flags = *reinterpret_cast<const uint32_t*>(method.artMethod + kAccessFlagsOffset);
+
+        CodeOrigin origin = index.classify(entryPoint);
+        bool nativeFlipped = ((flags ^ method.baselineFlags) & kAccNative) != 0;
+        if (!isTrustedEntryPoint(origin) || nativeFlipped) {
+            suspicious++;
+            if (report) {
+                EVLOG_W(HookedArtMethod, method.artMethod, eventlog::intern(index.pathOf(entryPoint)),
+                        eventlog::intern(ModuleIndex::originName(origin)));
+                if (nativeFlipped) {
+                    EVLOG_W(ArtMethodFlagsChanged, method.artMethod, method.baselineFlags, flags);
+                }
+            }
+        }
+    }
+    return suspicious;
+}
+
+} // namespace
+
+/**
+ * 检测 Hook：ArtMethod 入口完整性
+ * LSPosed/Pine/SandHook 会替换方法的 quick 入口指向自己的跳板，
+ * 正常的入口只可能在 libart、boot image/应用的 oat 或 JIT 缓存中
+ */
+bool checkArtMethodEntryPoints(JNIEnv* env, jobjectArray methods) {
+    std::lock_guard<std::mutex> lock(g_trackedMutex);
+    if (g_trackedMethods.empty() && methods != nullptr) {
+        resolveMethods(env, methods);
+    }
+    if (g_trackedMethods.empty()) {
+        return false;
+    }
+
+    ModuleIndex index(currentSnapshot().maps());
+    if (countSuspiciousMethods(index, false) == 0) {
+        return false;
+    }
+
+    // 入口可能落在快照之后才扩展的 JIT 区域，用新读取的 maps 再确认
+    std::string content;
+    if (!readFileFully("/proc/self/maps", content)) {
+        return false;
+    }
+    MapsSnapshot fresh;
+    fresh.parse(content);
+    ModuleIndex freshIndex(fresh);
+    return countSuspiciousMethods(freshIndex, true) > 0;
+}
+
+extern "C"
+JNIEXPORT jboolean JNICALL
+Java_com_grtsinry43_environmentdetector_security_NativeSecurityDetector_nativeCheckArtMethods(
+        JNIEnv* env,
+        jclass clazz,
+        jobjectArray methods) {
+
+    EVLOG_D(CheckStarted, CheckId::ArtMethods);
+
+    bool hooked = checkArtMethodEntryPoints(env, methods);
+
+    EVLOG_I(CheckResult, CheckId::ArtMethods, hooked);
+    return hooked;
+}
@@ -0,0 +1,237 @@
+#include "baseline_store.h"
+
+#include <jni.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+#include <android/log.h>
+
+#include "sys_io.h"
+
+#define LOG_TAG "BaselineStore"
+#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN, LOG_TAG, __VA_ARGS__)
+
+namespace {
+
+// EWMA 平滑系数：约等于最近 10 次扫描的加权平均
+constexpr double kAlpha = 0.1;
+
+// 样本数达到这个值之前只学习，不判定
+constexpr uint32_t kWarmupSamples = 5;
+
+// 偏离历史均值超过这么多个标准差才判定异常
+constexpr double kDeviationFactor = 4.0;
+
+// 连续这么多次异常后接受新的水平：一次注入只影响当次扫描，持续存在的变化视为设备的新常态
+constexpr uint32_t kRelearnAfter = 3;
+
+// 标准差下限：计数是整数且经常长期不变，至少容忍 1 或均值的 10%
+constexpr double kMinDeviation = 1.0;
+constexpr double kMinRelativeDeviation = 0.1;
+
+constexpr uint32_t kFileMagic = 0x4C424445;  // "EDBL"
+constexpr uint16_t kFileVersion = 1;
+
+/**
+ * 单个指标的 EWMA 均值与方差
+ * anomalyStreak 占用旧版本的保留字段（旧文件中为 0），文件格式不变
+ */
+struct MetricState {
+    float mean;
+    float variance;
+    uint32_t samples;
+    uint32_t anomalyStreak;
+};
+
+/**
+ * 持久化格式：文件头加上按 Metric 顺序排列的定长状态，共 72 字节
+ */
+struct BaselineFile {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t count;
+    MetricState metrics[static_cast<size_t>(Metric::Count)];
+};
+
+std::once_flag g_initOnce;
+std::mutex g_storeMutex;
+std::string g_path;
+BaselineFile g_store{};
+bool g_dirty = false;
+
+// 只串行化文件写入，观测不会因为落盘而阻塞
+std::mutex g_flushMutex;
+
+void loadStore() {
+    int fd = sysio::openat(AT_FDCWD, g_path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return;
+    }
+    BaselineFile file{};
+    ssize_t n = sysio::read(fd, &file, sizeof(file));
+    sysio::close(fd);
+
+    if (n != static_cast<ssize_t>(sizeof(file)) || file.magic != kFileMagic ||
+        file.version != kFileVersion || file.count != static_cast<uint16_t>(Metric::Count)) {
+        LOGW("Ignoring incompatible baseline file");
+        return;
+    }
+    g_store = file;
+}
+
+/**
+ * 写临时文件后 rename，进程中途被杀也不会留下半个文件
+ */
+void saveStore(const BaselineFile& store) {
+    std::string temp = g_path + ".tmp";
+    int fd = open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        return;
+    }
+    bool ok = write(fd, &store, sizeof(store)) == static_cast<ssize_t>(sizeof(store));
+    close(fd);
+    if (!ok || rename(temp.c_str(), g_path.c_str()) != 0) {
+        unlink(temp.c_str());
+    }
+}
+
+double allowedDeviation(const MetricState& state) {
+    double deviation = std::sqrt(static_cast<double>(state.variance));
+    double floor = std::max(kMinDeviation, kMinRelativeDeviation * std::fabs(static_cast<double>(state.mean)));
+    return std::max(deviation, floor);
+}
+
+/**
+ * 接受新的水平：均值直接跳到当前值，方差清零由下限兜底；已经过了学习期，之后不再回到固定阈值
+ */
+void relearn(MetricState& state, double value) {
+    state.mean = static_cast<float>(value);
+    state.variance = 0;
+    state.samples = std::max(state.samples, kWarmupSamples);
+    state.anomalyStreak = 0;
+}
+
+void update(MetricState& state, double value) {
+    if (state.samples == 0) {
+        state.mean = static_cast<float>(value);
+        state.variance = 0;
+    } else {
+        double delta = value - state.mean;
+        double mean = state.mean + kAlpha * delta;
+        state.variance = static_cast<float>((1 - kAlpha) * (state.variance + kAlpha * delta * delta));
+        state.mean = static_cast<float>(mean);
+    }
+    state.samples++;
+    state.anomalyStreak = 0;
+}
+
+} // namespace
+
+void initBaselineStore(const char* path) {
+    std::call_once(g_initOnce, [path] {
+        std::lock_guard<std::mutex> lock(g_storeMutex);
+        g_store.magic = kFileMagic;
+        g_store.version = kFileVersion;
+        g_store.count = static_cast<uint16_t>(Metric::Count);
+        g_path = path;
+        loadStore();
+    });
+}
+
+MetricVerdict observeMetric(Metric metric, double value, double warmupThreshold) {
+    std::lock_guard<std::mutex> lock(g_storeMutex);
+    if (g_path.empty()) {
+        // 没有指定基线文件（离线回放等不属于某台设备的场景），不学习也不判定
+        return MetricVerdict::Learning;
+    }
+    MetricState& state = g_store.metrics[static_cast<size_t>(metric)];
+
+    // 学习期按固定阈值判定，之后只看本设备的历史
+    double limit = warmupThreshold;
+    if (state.samples >= kWarmupSamples) {
+        limit = state.mean + kDeviationFactor * allowedDeviation(state);
+        LOGD("Metric %d: %.0f vs mean %.1f (limit %.1f, %u samples)",
+             static_cast<int>(metric), value, state.mean, limit, state.samples);
+    }
+
+    g_dirty = true;
+    if (value <= limit) {
+        update(state, value);
+        return MetricVerdict::Normal;
+    }
+    if (++state.anomalyStreak < kRelearnAfter) {
+        return MetricVerdict::Anomalous;
+    }
+    LOGD("Metric %d: %u consecutive anomalies, accepting %.0f as the new level",
+         static_cast<int>(metric), state.anomalyStreak, value);
+    relearn(state, value);
+    return MetricVerdict::Normal;
+}
+
+void flushBaselineStore() {
+    BaselineFile store;
+    {
+        std::lock_guard<std::mutex> lock(g_storeMutex);
+        if (!g_dirty || g_path.empty()) {
+            return;
+        }
+        store = g_store;
+        g_dirty = false;
+    }
+    // g_path 在初始化后不再改变，写文件不需要持有状态锁
+    std::lock_guard<std::mutex> lock(g_flushMutex);
+    saveStore(store);
+}
+
+/**
+ * 指定基线文件（应用私有目录），由 Java 层在首次检测前调用
+ */
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_grtsinry43_environmentdetector_security_NativeSecurityDetector_nativeInitBaselineStore(
+        JNIEnv* env,
+        jclass clazz,
+        jstring path) {
+
+    const char* pathChars = env->GetStringUTFChars(path, nullptr);
+    if (pathChars == nullptr) {
+        return;
+    }
+    initBaselineStore(pathChars);
+    env->ReleaseStringUTFChars(path, pathChars);
+}
+
+/**
+ * 记录一次计数观测，返回 MetricVerdict（-1 没有基线文件，0 正常，1 异常）
+ * warmupThreshold 为调用方的固定阈值，只在学习期使用
+ */
+extern "C"
+JNIEXPORT jint JNICALL
+Java_com_grtsinry43_environmentdetector_security_NativeSecurityDetector_nativeObserveMetric(
+        JNIEnv* env,
+        jclass clazz,
+        jint metric,
+        jint value,
+        jint warmupThreshold) {
+
+    if (metric < 0 || metric >= static_cast<jint>(Metric::Count)) {
+        return static_cast<jint>(MetricVerdict::Learning);
+    }
+    return static_cast<jint>(observeMetric(static_cast<Metric>(metric), value, warmupThreshold));
+}
+
+/**
+ * 一轮扫描结束后把更新过的基线写回文件
+ */
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_grtsinry43_environmentdetector_security_NativeSecurityDetector_nativeFlushBaselineStore(
+        JNIEnv* env,
+        jclass clazz) {
+    flushBaselineStore();
+}
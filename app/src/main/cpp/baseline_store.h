@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+#include "native_api.h"
+
+NATIVE_API_BEGIN
+
+/**
+ * 计数类启发式的指标，数值越大越可疑
+ * 编号与 Kotlin 侧 NativeSecurityDetector.METRIC_* 一致，持久化文件也按这个顺序存储
+ */
+enum class Metric : uint8_t {
+    FdCount,         // /proc/self/fd 中的 fd 总数
+    BindMounts,      // mountinfo 中的 bind mount 行数
+    DexElements,     // 应用 ClassLoader 的 dexElements 数量
+    MissingSensors,  // 缺失的关键传感器数量
+    Count
+};
+
+/**
+ * 一次观测的判定
+ */
+enum class MetricVerdict : int {
+    Learning = -1,   // 没有基线文件，由调用方按固定阈值判定
+    Normal = 0,
+    Anomalous = 1
+};
+
+/**
+ * 指定持久化文件并载入已有历史；重复调用只有第一次生效
+ */
+void initBaselineStore(const char* path);
+
+/**
+ * 记录一次观测并与本设备的历史比较，O(1)
+ * warmupThreshold 是固定阈值，只在历史样本不足的学习期使用，之后完全按本设备的基线判定；
+ * 异常的观测不会并入历史，避免注入后慢慢把基线拉高，但连续多次异常说明设备换了水平（刷机、应用变大），
+ * 这时接受新的水平重新学习，否则会永远误报；更新只在内存中，由 flushBaselineStore 落盘
+ * 未调用 initBaselineStore 时不学习，返回 Learning
+ */
+MetricVerdict observeMetric(Metric metric, double value, double warmupThreshold = HUGE_VAL);
+
+/**
+ * 把本轮扫描中更新过的基线写回文件，每轮扫描结束时调用一次；没有变化时不做任何事
+ */
+void flushBaselineStore();
+
+NATIVE_API_END
@@ -0,0 +1,300 @@
+#include <jni.h>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <android/log.h>
+
+#if defined(__aarch64__) || (defined(__arm__) && defined(__ARM_NEON))
+#include <arm_neon.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <emmintrin.h>
+#endif
+
+#include "event_log.h"
+#include "proc_snapshot.h"
+#include "proc_utils.h"
+#include "sys_io.h"
+
+#define LOG_TAG "BreakpointScan"
+#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+
+namespace {
+
+// 单个函数只比对开头这一段，调试器的断点几乎都下在函数入口附近
+constexpr size_t kFunctionWindow = 64;
+
+/**
+ * 统计一段代码中的软件断点编码
+ * 只做计数，不判断是否真的是指令：数据和立即数里的偶然命中在文件里同样存在，
+ * 与文件基线的计数相比较即可
+ */
+#if defined(__aarch64__)
+
+// BRK #imm16: 1101 0100 001 imm16 00000
+size_t countBreakpoints(const uint8_t* code, size_t len) {
+    const uint32x4_t mask = vdupq_n_u32(0xFFE0001Fu);
+    const uint32x4_t brk = vdupq_n_u32(0xD4200000u);
+    uint32x4_t acc = vdupq_n_u32(0);
+
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        uint32x4_t words = vld1q_u32(reinterpret_cast<const uint32_t*>(code + i));
+        // 命中的通道为全 1（即 -1），减去它相当于计数加一
+        acc = vsubq_u32(acc, vceqq_u32(vandq_u32(words, mask), brk));
+    }
+    size_t count = vaddvq_u32(acc);
+    for (; i + 4 <= len; i += 4) {
+        uint32_t word;
+        memcpy(&word, code + i, sizeof(word));
+        if ((word & 0xFFE0001Fu) == 0xD4200000u) count++;
+    }
+    return count;
+}
+
+#elif defined(__arm__)
+
+/**
+ * NDK 默认以 Thumb-2 编译 armeabi-v7a，按半字匹配：
+ * BKPT 0xBExx、UDF 0xDExx（gdb/lldb 在 Thumb 下用 0xDE01，ARM 下的 0xE7FFDEFE 也含 0xDEFE）
+ */
+inline bool isThumbBreakpoint(uint16_t half) {
+    uint16_t high = half & 0xFF00u;
+    return high == 0xBE00u || high == 0xDE00u;
+}
+
+size_t countBreakpoints(const uint8_t* code, size_t len) {
+    size_t count = 0;
+    size_t i = 0;
+#if defined(__ARM_NEON)
+    const uint16x8_t mask = vdupq_n_u16(0xFF00u);
+    const uint16x8_t bkpt = vdupq_n_u16(0xBE00u);
+    const uint16x8_t udf = vdupq_n_u16(0xDE00u);
+    uint16x8_t acc = vdupq_n_u16(0);
+    // 16 位累加器每 4096 轮清算一次，避免溢出
+    size_t rounds = 0;
+    for (; i + 16 <= len; i += 16) {
+        uint16x8_t high = vandq_u16(vld1q_u16(reinterpret_cast<const uint16_t*>(code + i)), mask);
+        acc = vsubq_u16(acc, vorrq_u16(vceqq_u16(high, bkpt), vceqq_u16(high, udf)));
+        if (++rounds == 4096) {
+            uint32x4_t wide = vpaddlq_u16(acc);
+            count += vgetq_lane_u32(wide, 0) + vgetq_lane_u32(wide, 1) +
+                     vgetq_lane_u32(wide, 2) + vgetq_lane_u32(wide, 3);
+            acc = vdupq_n_u16(0);
+            rounds = 0;
+        }
+    }
+    uint32x4_t wide = vpaddlq_u16(acc);
+    count += vgetq_lane_u32(wide, 0) + vgetq_lane_u32(wide, 1) +
+             vgetq_lane_u32(wide, 2) + vgetq_lane_u32(wide, 3);
+#endif
+    for (; i + 2 <= len; i += 2) {
+        uint16_t half;
+        memcpy(&half, code + i, sizeof(half));
+        if (isThumbBreakpoint(half)) count++;
+    }
+    return count;
+}
+
+#elif defined(__x86_64__) || defined(__i386__)
+
+// INT3: 0xCC
+size_t countBreakpoints(const uint8_t* code, size_t len) {
+    const __m128i int3 = _mm_set1_epi8(static_cast<char>(0xCC));
+    size_t count = 0;
+
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(code + i));
+        int bits = _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, int3));
+        count += static_cast<size_t>(__builtin_popcount(static_cast<unsigned>(bits)));
+    }
+    for (; i < len; i++) {
+        if (code[i] == 0xCC) count++;
+    }
+    return count;
+}
+
+#else
+
+size_t countBreakpoints(const uint8_t* code, size_t len) {
+    return 0;
+}
+
+#endif
+
+/**
+ * 文件中一页代码的基线：长度、摘要和断点编码计数
+ */
+struct CodePageBaseline {
+    uintptr_t address;
+    uint32_t length;
+    uint32_t breakpoints;
+    uint64_t digest;
+};
+
+/**
+ * 单个热点函数开头的文件原始字节
+ */
+struct FunctionBaseline {
+    uintptr_t address;
+    size_t length;
+    uint8_t bytes[kFunctionWindow];
+};
+
+struct OwnCodeBaseline {
+    std::vector<CodePageBaseline> pages;
+    std::vector<FunctionBaseline> functions;
+};
+
+OwnCodeBaseline g_ownCode;
+
+// 页基线只构建一次；函数基线按需追加，查找和追加都在锁内
+std::once_flag g_pageBaselineOnce;
+std::mutex g_functionMutex;
+
+/**
+ * 函数地址 -> 代码地址（Thumb 函数指针最低位为 1）
+ */
+uintptr_t codeAddressOf(const void* fn) {
+    auto addr = reinterpret_cast<uintptr_t>(fn);
+#if defined(__arm__)
+    addr &= ~static_cast<uintptr_t>(1);
+#endif
+    return addr;
+}
+
+/**
+ * 打开 addr 所在映射背后的文件，并算出 addr 对应的文件偏移
+ * 库直接从 APK 加载时路径是 base.apk，偏移同样有效
+ */
+int openBackingFile(uintptr_t addr, const MapEntry*& entry, uint64_t& fileOffset) {
+    const MapsSnapshot& maps = currentSnapshot().maps();
+    entry = maps.find(addr);
+    if (entry == nullptr || entry->inode == 0 || (entry->perms & kMapExec) == 0) {
+        return -1;
+    }
+    fileOffset = entry->offset + (addr - entry->start);
+    return sysio::openat(AT_FDCWD, maps.pathOf(*entry).c_str(), O_RDONLY | O_CLOEXEC);
+}
+
+/**
+ * 第一次扫描时从磁盘文件建立本库代码段的逐页基线
+ * 基线来自文件而不是内存，所以扫描前就已经下好的断点同样能被发现
+ */
+void buildPageBaseline() {
+    const MapEntry* entry = nullptr;
+    uint64_t fileOffset = 0;
+    int fd = openBackingFile(codeAddressOf(reinterpret_cast<const void*>(&buildPageBaseline)),
+                             entry, fileOffset);
+    if (fd < 0) {
+        return;
+    }
+
+    size_t pageSize = static_cast<size_t>(getpagesize());
+    std::vector<uint8_t> filePage(pageSize);
+    for (uintptr_t page = entry->start; page < entry->end; page += pageSize) {
+        uint64_t offset = entry->offset + (page - entry->start);
+        ssize_t n = sysio::pread64(fd, filePage.data(), pageSize, static_cast<int64_t>(offset));
+        if (n <= 0) break;
+
+        size_t len = static_cast<size_t>(n);
+        g_ownCode.pages.push_back({
+                page,
+                static_cast<uint32_t>(len),
+                static_cast<uint32_t>(countBreakpoints(filePage.data(), len)),
+                fnv1a64(reinterpret_cast<const char*>(filePage.data()), len)
+        });
+    }
+    sysio::close(fd);
+    LOGD("Own code baseline: %zu pages", g_ownCode.pages.size());
+}
+
+const FunctionBaseline* functionBaseline(uintptr_t addr) {
+    for (const FunctionBaseline& function : g_ownCode.functions) {
+        if (function.address == addr) return &function;
+    }
+
+    const MapEntry* entry = nullptr;
+    uint64_t fileOffset = 0;
+    int fd = openBackingFile(addr, entry, fileOffset);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    FunctionBaseline function{};
+    function.address = addr;
+    size_t window = entry->end - addr < kFunctionWindow ? entry->end - addr : kFunctionWindow;
+    ssize_t n = sysio::pread64(fd, function.bytes, window, static_cast<int64_t>(fileOffset));
+    sysio::close(fd);
+    if (n <= 0) {
+        return nullptr;
+    }
+    function.length = static_cast<size_t>(n);
+    g_ownCode.functions.push_back(function);
+    return &g_ownCode.functions.back();
+}
+
+} // namespace
+
+/**
+ * 检测调试器：本库代码段中的软件断点
+ * 隐藏了 TracerPid 的调试器仍然需要往代码里写 BRK/BKPT/INT3；
+ * 每页先用 SIMD 统计断点编码并与文件基线比较，再比对页摘要，
+ * 基线只在第一次扫描时从文件读取一次，之后的扫描不再有文件 I/O
+ */
+bool checkCodeBreakpoints() {
+    std::call_once(g_pageBaselineOnce, buildPageBaseline);
+
+    int planted = 0;
+    int modified = 0;
+    for (const CodePageBaseline& page : g_ownCode.pages) {
+        const auto* code = reinterpret_cast<const uint8_t*>(page.address);
+        size_t breakpoints = countBreakpoints(code, page.length);
+        if (breakpoints > page.breakpoints) {
+            planted++;
+            EVLOG_W(CodeBreakpoints, page.address, breakpoints, page.breakpoints);
+        } else if (fnv1a64(reinterpret_cast<const char*>(code), page.length) != page.digest) {
+            modified++;
+            EVLOG_W(OwnCodeModified, page.address);
+        }
+    }
+
+    EVLOG_D(OwnCodePages, g_ownCode.pages.size(), planted, modified);
+    return planted > 0 || modified > 0;
+}
+
+/**
+ * 单函数检查：只比对函数开头的一小段，供 JNI 入口等热点函数在每次调用时使用
+ */
+bool checkFunctionBreakpoints(const void* fn) {
+    uintptr_t addr = codeAddressOf(fn);
+    std::lock_guard<std::mutex> lock(g_functionMutex);
+    const FunctionBaseline* baseline = functionBaseline(addr);
+    if (baseline == nullptr) {
+        return false;
+    }
+    if (memcmp(reinterpret_cast<const void*>(addr), baseline->bytes, baseline->length) == 0) {
+        return false;
+    }
+    EVLOG_W(PatchedFunction, addr,
+            countBreakpoints(reinterpret_cast<const uint8_t*>(addr), baseline->length),
+            countBreakpoints(baseline->bytes, baseline->length));
+    return true;
+}
+
+extern "C"
+JNIEXPORT jboolean JNICALL
+Java_com_grtsinry43_environmentdetector_security_NativeSecurityDetector_nativeCheckCodeBreakpoints(
+        JNIEnv* env,
+        jclass clazz) {
+
+    EVLOG_D(CheckStarted, CheckId::CodeBreakpoints);
+
+    bool detected = checkCodeBreakpoints();
+
+    EVLOG_I(CheckResult, CheckId::CodeBreakpoints, detected);
+    return detected;
+}
@@ -0,0 +1,280 @@
+#include <jni.h>
+#include <cerrno>
+#include <cstring>
+#include <string_view>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "event_log.h"
+#include "proc_utils.h"
+#include "timing_probe.h"
+
+namespace {
+
+// 一次探测最多并发的端口数
+constexpr size_t kMaxTargets = 64;
+
+// 整轮探测的总时限
+constexpr int64_t kDeadlineNs = 50 * 1000 * 1000;
+
+// 读不到套接字表时（Android 10 起 /proc/net 对应用受限）退回探测的默认端口
+constexpr uint16_t kDefaultPorts[] = {27042, 27043};
+
+// D-Bus 认证握手：先发一个 '\0' 字节，再发 AUTH 命令
+constexpr char kAuthRequest[] = "\0AUTH\r\n";
+
+// D-Bus 服务端对不带机制的 AUTH 的回复，frida-server 实现了这一协议
+constexpr char kAuthRejected[] = "REJECTED";
+
+/**
+ * 一个待探测的监听端口
+ */
+struct ProbeTarget {
+    int family;
+    uint16_t port;
+    int fd;
+    enum State : uint8_t {
+        Connecting,
+        AwaitingReply,
+        Done
+    } state;
+};
+
+struct ProbeSet {
+    ProbeTarget targets[kMaxTargets];
+    size_t count;
+};
+
+/**
+ * 按（协议族, 端口）去重：同一端口号在 IPv4 和 IPv6 上可能是两个不同的服务
+ */
+void addTarget(ProbeSet& set, int family, uint16_t port) {
+    for (size_t i = 0; i < set.count; i++) {
+        if (set.targets[i].family == family && set.targets[i].port == port) return;
+    }
+    if (set.count < kMaxTargets) {
+        set.targets[set.count++] = {family, port, -1, ProbeTarget::Connecting};
+    }
+}
+
+uint16_t parseHexPort(std::string_view text) {
+    uint16_t port = 0;
+    for (char c : text) {
+        int digit = c >= '0' && c <= '9' ? c - '0' : (c >= 'A' && c <= 'F' ? c - 'A' + 10 : -1);
+        if (digit < 0) break;
+        port = static_cast<uint16_t>(port * 16 + digit);
+    }
+    return port;
+}
+
+/**
+ * 只探测本机可达的监听地址：回环地址或通配地址
+ * 内核以主机字节序逐 32 位输出，小端机器上 127.0.0.1 为 0100007F
+ */
+bool isLocalAddress(std::string_view address) {
+    if (address.size() == 8) {
+        return address == "00000000" || address.compare(6, 2, "7F") == 0;
+    }
+    if (address.size() == 32) {
+        return address == "00000000000000000000000000000000" ||
+               address == "00000000000000000000000001000000" ||
+               address.compare(0, 24, "0000000000000000FFFF0000") == 0;
+    }
+    return false;
+}
+
+/**
+ * 从 /proc/net/tcp{,6} 中收集处于 LISTEN（0A）状态的本地端口
+ * 行格式：sl local_address rem_address st ...
+ */
+bool collectListeners(ProbeSet& set, const char* path, int family) {
+    return forEachLine(path, [&set, family](const char* line, size_t len) {
+        std::string_view text(line, len);
+        size_t pos = text.find(':');
+        if (pos == std::string_view::npos) return true;
+
+        // 跳过 "sl:"，取 local_address、rem_address、st
+        std::string_view fields[3];
+        size_t cursor = pos + 1;
+        for (std::string_view& field : fields) {
+            while (cursor < len && line[cursor] == ' ') cursor++;
+            size_t start = cursor;
+            while (cursor < len && line[cursor] != ' ') cursor++;
+            field = text.substr(start, cursor - start);
+        }
+        if (fields[2] != "0A") return true;
+
+        size_t colon = fields[0].find(':');
+        if (colon == std::string_view::npos || !isLocalAddress(fields[0].substr(0, colon))) return true;
+        addTarget(set, family, parseHexPort(fields[0].substr(colon + 1)));
+        return true;
+    });
+}
+
+bool startConnect(ProbeTarget& target, int epollFd, size_t index) {
+    target.fd = socket(target.family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (target.fd < 0) return false;
+
+    int rc;
+    if (target.family == AF_INET6) {
+        struct sockaddr_in6 addr{};
+        addr.sin6_family = AF_INET6;
+        addr.sin6_port = htons(target.port);
+        addr.sin6_addr = in6addr_loopback;
+        rc = connect(target.fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr));
+    } else {
+        struct sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(target.port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        rc = connect(target.fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr));
+    }
+    if (rc != 0 && errno != EINPROGRESS) return false;
+
+    struct epoll_event event{};
+    event.events = EPOLLOUT;
+    event.data.u64 = index;
+    return epoll_ctl(epollFd, EPOLL_CTL_ADD, target.fd, &event) == 0;
+}
+
+void finish(ProbeTarget& target, int& pending) {
+    if (target.fd >= 0) {
+        close(target.fd);
+        target.fd = -1;
+    }
+    if (target.state != ProbeTarget::Done) {
+        target.state = ProbeTarget::Done;
+        pending--;
+    }
+}
+
+/**
+ * 处理一个就绪事件，返回该端口是否回复了 D-Bus 握手
+ * 连接完成（可写）后发送 AUTH 并改为等待可读；收到回复后按前缀分类
+ */
+bool handleEvent(ProbeSet& set, size_t index, int epollFd, uint32_t events, int& pending) {
+    ProbeTarget& target = set.targets[index];
+    if (target.state == ProbeTarget::Done) {
+        return false;
+    }
+
+    if (target.state == ProbeTarget::Connecting) {
+        int error = 0;
+        socklen_t len = sizeof(error);
+        if ((events & (EPOLLERR | EPOLLHUP)) != 0 ||
+            getsockopt(target.fd, SOL_SOCKET, SO_ERROR, &error, &len) != 0 || error != 0 ||
+            send(target.fd, kAuthRequest, sizeof(kAuthRequest) - 1, MSG_NOSIGNAL) < 0) {
+            finish(target, pending);
+            return false;
+        }
+
+        struct epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u64 = index;
+        if (epoll_ctl(epollFd, EPOLL_CTL_MOD, target.fd, &event) != 0) {
+            finish(target, pending);
+            return false;
+        }
+        target.state = ProbeTarget::AwaitingReply;
+        return false;
+    }
+
+    char reply[64];
+    ssize_t n = recv(target.fd, reply, sizeof(reply), MSG_DONTWAIT);
+    if (n < 0 && errno == EAGAIN && (events & (EPOLLERR | EPOLLHUP)) == 0) {
+        return false;
+    }
+    finish(target, pending);
+    return n >= static_cast<ssize_t>(sizeof(kAuthRejected) - 1) &&
+           memcmp(reply, kAuthRejected, sizeof(kAuthRejected) - 1) == 0;
+}
+
+/**
+ * 并发探测所有目标，返回回复了 D-Bus 握手的端口数
+ */
+int probeTargets(ProbeSet& set) {
+    int epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd < 0) {
+        return 0;
+    }
+
+    int pending = 0;
+    for (size_t i = 0; i < set.count; i++) {
+        pending++;
+        if (!startConnect(set.targets[i], epollFd, i)) {
+            finish(set.targets[i], pending);
+        }
+    }
+
+    int responders = 0;
+    int64_t deadline = monotonicNowNs() + kDeadlineNs;
+    struct epoll_event events[16];
+    while (pending > 0) {
+        int64_t remainingNs = deadline - monotonicNowNs();
+        if (remainingNs <= 0) break;
+
+        int timeoutMs = static_cast<int>((remainingNs + 999999) / 1000000);
+        int n = epoll_wait(epollFd, events, sizeof(events) / sizeof(events[0]), timeoutMs);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+
+        for (int i = 0; i < n; i++) {
+            auto index = static_cast<size_t>(events[i].data.u64);
+            if (handleEvent(set, index, epollFd, events[i].events, pending)) {
+                responders++;
+                EVLOG_W(DbusResponder, set.targets[index].port);
+            }
+        }
+    }
+
+    // 超时未完成的连接直接关闭
+    for (size_t i = 0; i < set.count; i++) {
+        finish(set.targets[i], pending);
+    }
+    close(epollFd);
+    return responders;
+}
+
+} // namespace
+
+/**
+ * 检测 Hook：本机监听端口的 D-Bus 握手探测
+ * frida-server 可以监听任意端口，但它说的是 D-Bus 协议：
+ * 对套接字表中所有本机可达的 LISTEN 端口并发发起非阻塞连接，用一个 epoll 实例复用，
+ * 发送 AUTH 握手，回复 REJECTED 的就是 D-Bus 服务端；整轮探测共享 50ms 的总时限
+ */
+bool probeDbusListeners() {
+    ProbeSet set{};
+    bool tcp4Ok = collectListeners(set, "/proc/net/tcp", AF_INET);
+    bool tcp6Ok = collectListeners(set, "/proc/net/tcp6", AF_INET6);
+    if (!tcp4Ok && !tcp6Ok) {
+        for (uint16_t port : kDefaultPorts) {
+            addTarget(set, AF_INET, port);
+        }
+    }
+    if (set.count == 0) {
+        return false;
+    }
+
+    int64_t start = monotonicNowNs();
+    int responders = probeTargets(set);
+    EVLOG_D(DbusProbeSummary, set.count, (monotonicNowNs() - start) / 1000, responders);
+    return responders > 0;
+}
+
+extern "C"
+JNIEXPORT jboolean JNICALL
+Java_com_grtsinry43_environmentdetector_security_NativeSecurityDetector_nativeProbeDbusListeners(
+        JNIEnv* env,
+        jclass clazz) {
+
+    EVLOG_D(CheckStarted, CheckId::DbusListeners);
+
+    bool detected = probeDbusListeners();
+
+    EVLOG_I(CheckResult, CheckId::DbusListeners, detected);
+    return detected;
+}
@@ -0,0 +1,158 @@
+#include <jni.h>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <android/log.h>
+
+#include "event_log.h"
+#include "proc_snapshot.h"
+#include "proc_utils.h"
+#include "sys_io.h"
+
+#define LOG_TAG "DirtyPages"
+#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+
+namespace {
+
+// 单次扫描最多比对的页数，限制最坏情况下的开销
+constexpr int kMaxComparedPages = 256;
+
+// pagemap 表项标志位（Documentation/admin-guide/mm/pagemap.rst）
+constexpr uint64_t kPagemapPresent = 1ULL << 63;
+constexpr uint64_t kPagemapFileOrShared = 1ULL << 61;
+
+/**
+ * 第一层筛选出的候选映射：可执行的文件映射，但存在私有脏页
+ */
+struct DirtyCandidate {
+    uintptr_t start;
+    uintptr_t end;
+    uint64_t offset;
+    std::string path;
+};
+
+/**
+ * 第一层：只看 smaps 计数
+ * 代码段正常情况下与文件共享页缓存，Private_Dirty 必然为 0；
+ * inline Hook 写入代码会触发写时复制，页面变成私有脏页
+ */
+void collectCandidates(const std::string& smaps, std::vector<DirtyCandidate>& candidates) {
+    forEachSmapsEntry(smaps, [&candidates](const MapEntry& entry, std::string_view path,
+                                           uint64_t privateDirtyKb) {
+        if (privateDirtyKb == 0) return;
+        if ((entry.perms & kMapExec) == 0 || (entry.perms & kMapRead) == 0) return;
+        if ((entry.perms & kMapShared) != 0 || path.empty() || path[0] != '/') return;
+
+        candidates.push_back({entry.start, entry.end, entry.offset, std::string(path)});
+    });
+}
+
+/**
+ * 比对一页内存与文件中对应位置的内容
+ */
+bool pageMatchesFile(int fileFd, uintptr_t page, uint64_t fileOffset, std::vector<char>& filePage) {
+    ssize_t n = sysio::pread64(fileFd, filePage.data(), filePage.size(), static_cast<int64_t>(fileOffset));
+    if (n <= 0) {
+        // 文件末尾之外的部分无从比较，不作判断
+        return true;
+    }
+    uint64_t memoryHash = fnv1a64(reinterpret_cast<const char*>(page), static_cast<size_t>(n));
+    uint64_t fileHash = fnv1a64(filePage.data(), static_cast<size_t>(n));
+    return memoryHash == fileHash;
+}
+
+/**
+ * 第二层：读取候选映射的 pagemap，定位具体的私有页，只对这些页做哈希比对
+ * 返回被修改的页数
+ */
+int inspectCandidate(int pagemapFd, const DirtyCandidate& candidate, size_t pageSize, int& budget) {
+    int fileFd = sysio::openat(AT_FDCWD, candidate.path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fileFd < 0) {
+        return 0;
+    }
+
+    int modified = 0;
+    std::vector<char> filePage(pageSize);
+    uint64_t entries[512];
+    uintptr_t page = candidate.start;
+    while (page < candidate.end && budget > 0) {
+        size_t pages = (candidate.end - page) / pageSize;
+        if (pages > sizeof(entries) / sizeof(entries[0])) pages = sizeof(entries) / sizeof(entries[0]);
+
+        int64_t pagemapOffset = static_cast<int64_t>(page / pageSize) * 8;
+        ssize_t n = sysio::pread64(pagemapFd, entries, pages * 8, pagemapOffset);
+        if (n <= 0) break;
+        pages = static_cast<size_t>(n) / 8;
+
+        for (size_t i = 0; i < pages && budget > 0; i++) {
+            uint64_t flags = entries[i];
+            if ((flags & kPagemapPresent) == 0 || (flags & kPagemapFileOrShared) != 0) continue;
+
+            // 在场且不再属于文件页缓存：写时复制后的私有页
+            uintptr_t dirtyPage = page + i * pageSize;
+            uint64_t fileOffset = candidate.offset + (dirtyPage - candidate.start);
+            budget--;
+            if (!pageMatchesFile(fileFd, dirtyPage, fileOffset, filePage)) {
+                modified++;
+                EVLOG_W(ModifiedCodePage, eventlog::intern(candidate.path), fileOffset);
+            }
+        }
+        page += pages * pageSize;
+    }
+
+    sysio::close(fileFd);
+    return modified;
+}
+
+} // namespace
+
+/**
+ * 检测 Hook：代码页脏页检测
+ * 先用 smaps 计数找到有私有脏页的代码映射，再用 pagemap 精确到页，
+ * 只对这些页与磁盘上的 ELF 做比对，覆盖 libc/libart/linker 中任意位置的 inline Hook
+ */
+bool checkDirtyCodePages() {
+    ProcSnapshot& snapshot = currentSnapshot();
+    if (!snapshot.available(ProcFile::Smaps)) {
+        return false;
+    }
+
+    std::vector<DirtyCandidate> candidates;
+    collectCandidates(snapshot.get(ProcFile::Smaps), candidates);
+    if (candidates.empty()) {
+        return false;
+    }
+
+    int pagemapFd = sysio::openat(AT_FDCWD, "/proc/self/pagemap", O_RDONLY | O_CLOEXEC);
+    if (pagemapFd < 0) {
+        return false;
+    }
+
+    size_t pageSize = static_cast<size_t>(getpagesize());
+    int budget = kMaxComparedPages;
+    int modified = 0;
+    for (const DirtyCandidate& candidate : candidates) {
+        modified += inspectCandidate(pagemapFd, candidate, pageSize, budget);
+        if (budget <= 0) break;
+    }
+    sysio::close(pagemapFd);
+
+    LOGD("Dirty code mappings: %zu, modified pages: %d", candidates.size(), modified);
+    return modified > 0;
+}
+
+extern "C"
+JNIEXPORT jboolean JNICALL
+Java_com_grtsinry43_environmentdetector_security_NativeSecurityDetector_nativeCheckDirtyCodePages(
+        JNIEnv* env,
+        jclass clazz) {
+
+    EVLOG_D(CheckStarted, CheckId::DirtyPages);
+
+    bool modified = checkDirtyCodePages();
+
+    EVLOG_I(CheckResult, CheckId::DirtyPages, modified);
+    return modified;
+}
@@ -0,0 +1,311 @@
+#include "early_stage.h"
+
+#include <jni.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unistd.h>
+#include <android/log.h>
+
+#include "event_log.h"
+#include "proc_snapshot.h"
+#include "proc_utils.h"
+#include "sys_io.h"
+#include "timing_probe.h"
+
+#define LOG_TAG "EarlyStage"
+#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN, LOG_TAG, __VA_ARGS__)
+
+// 外部声明信号处理函数基线采集
+extern void captureSignalBaseline();
+
+// 外部声明敏感环境变量键表匹配
+extern bool isSensitiveEnvironmentKey(std::string_view key);
+
+namespace {
+
+// 整个采集阶段的时限；maps 放在最后，超时就截断
+constexpr int64_t kBudgetNs = 800 * 1000;
+
+// Frida 的典型线程名，与 checkFridaThreads 一致
+const char* const kInjectorThreadNames[] = {
+        "gmain",
+        "gum-js-loop",
+        "gdbus",
+        "pool-frida"
+};
+
+// 线程池的工作线程空闲后会自行退出（kotlinx 的 Dispatchers.IO、Executors、AsyncTask），不作为常驻线程记录
+// 线程名在 comm 中被截断到 15 个字符
+const char* const kTransientThreadNames[] = {
+        "DefaultDispatch",
+        "pool-",
+        "AsyncTask"
+};
+
+// 匿名可执行映射允许的增长：本库的计时探测会临时映射一页代码，运行时偶尔也会新增一两段跳板
+constexpr int kAnonExecSlack = 2;
+
+// 加载时就已映射的注入库，与 checkLoadedLibraries 一致
+const char* const kInjectorLibraries[] = {
+        "frida",
+        "xposed",
+        "substrate",
+        "libriru",
+        "lsposed"
+};
+
+EarlyBaseline g_early{};
+
+template <size_t N>
+bool containsAny(std::string_view text, const char* const (&needles)[N]) {
+    for (const char* needle : needles) {
+        if (text.find(needle) != std::string_view::npos) return true;
+    }
+    return false;
+}
+
+template <size_t N>
+bool startsWithAny(std::string_view text, const char* const (&prefixes)[N]) {
+    for (const char* prefix : prefixes) {
+        if (text.compare(0, strlen(prefix), prefix) == 0) return true;
+    }
+    return false;
+}
+
+int parseTracerPid() {
+    int tracerPid = 0;
+    forEachLine("/proc/self/status", [&tracerPid](const char* line, size_t len) {
+        constexpr std::string_view kKey = "TracerPid:";
+        std::string_view text(line, len);
+        if (text.compare(0, kKey.size(), kKey) != 0) return true;
+        for (char c : text.substr(kKey.size())) {
+            if (c >= '0' && c <= '9') tracerPid = tracerPid * 10 + (c - '0');
+        }
+        return false;
+    });
+    return tracerPid;
+}
+
+void captureThreads(EarlyBaseline& baseline) {
+    int taskFd = sysio::openat(AT_FDCWD, "/proc/self/task", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (taskFd < 0) return;
+
+    forEachDirEntry(taskFd, [&baseline, taskFd](const sysio::Dirent64& entry) {
+        char commPath[64];
+        snprintf(commPath, sizeof(commPath), "%s/comm", entry.d_name);
+        int fd = sysio::openat(taskFd, commPath, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return true;
+        char comm[32];
+        ssize_t n = sysio::read(fd, comm, sizeof(comm));
+        sysio::close(fd);
+        if (n <= 0) return true;
+
+        std::string_view name(comm, static_cast<size_t>(n - 1));
+        bool injector = containsAny(name, kInjectorThreadNames);
+        if (injector) {
+            baseline.injectorThreads++;
+            EVLOG_W(InjectorThreadAtLoad, eventlog::intern(name));
+        }
+        if ((injector || !startsWithAny(name, kTransientThreadNames)) &&
+            baseline.threadCount < EarlyBaseline::kMaxThreads) {
+            baseline.threadIds[baseline.threadCount++] = atoi(entry.d_name);
+        }
+        return true;
+    });
+    sysio::close(taskFd);
+    std::sort(baseline.threadIds, baseline.threadIds + baseline.threadCount);
+}
+
+/**
+ * 只哈希敏感键表中的变量（LD_PRELOAD、FRIDA_* 等）
+ * 其它变量由框架在运行中正常增删，比较它们只会产生误报
+ */
+size_t hashEnviron(uint64_t* hashes, size_t capacity) {
+    size_t count = 0;
+    for (char** entry = environ; entry != nullptr && *entry != nullptr && count < capacity; entry++) {
+        std::string_view text(*entry);
+        size_t eq = text.find('=');
+        if (eq == std::string_view::npos || !isSensitiveEnvironmentKey(text.substr(0, eq))) continue;
+        hashes[count++] = fnv1a64(text.data(), text.size());
+    }
+    std::sort(hashes, hashes + count);
+    return count;
+}
+
+/**
+ * 流式扫描 maps，统计匿名可执行映射和注入库
+ * 行格式：start-end perms offset dev inode [path]
+ */
+void captureMaps(EarlyBaseline& baseline, int64_t deadline) {
+    baseline.mapsComplete = forEachLine("/proc/self/maps", [&baseline, deadline](const char* line, size_t len) {
+        baseline.mapsEntries++;
+
+        std::string_view text(line, len);
+        size_t perms = text.find(' ');
+        if (perms == std::string_view::npos || perms + 3 >= len || line[perms + 3] != 'x') {
+            return monotonicNowNs() < deadline;
+        }
+
+        // 跳过 perms offset dev inode 四个字段取路径
+        size_t pos = perms;
+        for (int field = 0; field < 4 && pos < len; field++) {
+            while (pos < len && line[pos] == ' ') pos++;
+            while (pos < len && line[pos] != ' ') pos++;
+        }
+        while (pos < len && line[pos] == ' ') pos++;
+        std::string_view path = text.substr(pos);
+        if (path.empty()) {
+            baseline.anonExecMappings++;
+        } else if (containsAny(path, kInjectorLibraries)) {
+            baseline.injectorMappings++;
+            EVLOG_W(InjectorLibraryAtLoad, eventlog::intern(path));
+        }
+        return monotonicNowNs() < deadline;
+    }) && monotonicNowNs() < deadline;
+}
+
+/**
+ * 库构造函数：在 System.loadLibrary 的 dlopen 中执行，早于 JNI_OnLoad 和 Java 层的任何初始化
+ * 按代价从低到高采集，全部写入静态定长结构，不分配堆内存
+ */
+__attribute__((constructor))
+void captureEarlyBaseline() {
+    EarlyBaseline& baseline = g_early;
+    int64_t start = monotonicNowNs();
+    baseline.capturedAtNs = start;
+
+    baseline.environCount = hashEnviron(baseline.environHashes, EarlyBaseline::kMaxEnviron);
+    baseline.tracerPid = parseTracerPid();
+    captureSignalBaseline();
+    captureThreads(baseline);
+    captureMaps(baseline, start + kBudgetNs);
+
+    baseline.costNs = monotonicNowNs() - start;
+    baseline.captured = true;
+    LOGD("Early baseline in %lld us: tracer %d, %zu threads, %zu env, %d maps (%s)",
+         static_cast<long long>(baseline.costNs / 1000), baseline.tracerPid, baseline.threadCount,
+         baseline.environCount, baseline.mapsEntries, baseline.mapsComplete ? "complete" : "truncated");
+}
+
+int countInjectorMappings() {
+    const PathInterner& paths = currentSnapshot().maps().paths();
+    int found = 0;
+    for (uint32_t id = 1; id < paths.size(); id++) {
+        if (containsAny(paths.path(id), kInjectorLibraries)) found++;
+    }
+    return found;
+}
+
+int countAnonExecMappings() {
+    int found = 0;
+    for (const MapEntry& entry : currentSnapshot().maps().entries()) {
+        if ((entry.perms & kMapExec) != 0 && entry.pathId == 0) found++;
+    }
+    return found;
+}
+
+/**
+ * 加载时的常驻线程中已经退出的个数，firstTid 为其中最小的 tid
+ * 只列出 tid，不读 comm
+ */
+size_t countVanishedThreads(const EarlyBaseline& baseline, int& firstTid) {
+    int taskFd = sysio::openat(AT_FDCWD, "/proc/self/task", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (taskFd < 0) return 0;
+
+    std::vector<int> current;
+    current.reserve(baseline.threadCount + 16);
+    forEachDirEntry(taskFd, [&current](const sysio::Dirent64& entry) {
+        current.push_back(atoi(entry.d_name));
+        return true;
+    });
+    sysio::close(taskFd);
+    std::sort(current.begin(), current.end());
+
+    size_t vanished = 0;
+    for (size_t i = 0; i < baseline.threadCount; i++) {
+        if (std::binary_search(current.begin(), current.end(), baseline.threadIds[i])) continue;
+        if (vanished++ == 0) firstTid = baseline.threadIds[i];
+    }
+    return vanished;
+}
+
+} // namespace
+
+const EarlyBaseline& earlyBaseline() {
+    return g_early;
+}
+
+/**
+ * 检测 Hook/调试器：与加载时基线比较
+ * 注入往往发生在 Java 层加载本库之前，加载那一刻的状态本身就是证据：
+ * 已有 tracer、已有 Frida 线程、已映射注入库；
+ * 之后的扫描再对比加载时存在、现在却消失的环境变量、注入库和常驻线程（注入器清理痕迹），
+ * 以及此后新增的匿名可执行映射（inline hook 的跳板、注入的 shellcode）
+ */
+bool checkEarlyStage() {
+    const EarlyBaseline& baseline = earlyBaseline();
+    if (!baseline.captured) {
+        return false;
+    }
+
+    bool suspicious = false;
+    if (baseline.tracerPid != 0) {
+        LOGW("Traced by %d at library load", baseline.tracerPid);
+        suspicious = true;
+    }
+    if (baseline.injectorThreads > 0 || baseline.injectorMappings > 0) {
+        suspicious = true;
+    }
+
+    int injectorMappings = countInjectorMappings();
+    if (baseline.injectorMappings > 0 && injectorMappings == 0) {
+        LOGW("Injector mappings present at load are no longer visible");
+    }
+
+    uint64_t current[EarlyBaseline::kMaxEnviron];
+    size_t currentCount = hashEnviron(current, EarlyBaseline::kMaxEnviron);
+    size_t removed = 0;
+    for (size_t i = 0; i < baseline.environCount; i++) {
+        if (!std::binary_search(current, current + currentCount, baseline.environHashes[i])) removed++;
+    }
+    if (removed > 0) {
+        LOGW("%zu sensitive environment entries removed since library load", removed);
+        suspicious = true;
+    }
+
+    int firstTid = 0;
+    size_t vanished = countVanishedThreads(baseline, firstTid);
+    if (vanished > 0) {
+        EVLOG_W(ThreadsVanishedSinceLoad, vanished, firstTid);
+        suspicious = true;
+    }
+
+    if (baseline.mapsComplete) {
+        int anonExec = countAnonExecMappings();
+        if (anonExec > baseline.anonExecMappings + kAnonExecSlack) {
+            EVLOG_W(AnonExecGrowthSinceLoad, baseline.anonExecMappings, anonExec);
+            suspicious = true;
+        }
+    }
+    return suspicious;
+}
+
+extern "C"
+JNIEXPORT jboolean JNICALL
+Java_com_grtsinry43_environmentdetector_security_NativeSecurityDetector_nativeCheckEarlyStage(
+        JNIEnv* env,
+        jclass clazz) {
+
+    EVLOG_D(CheckStarted, CheckId::EarlyStage);
+
+    bool suspicious = checkEarlyStage();
+
+    EVLOG_I(CheckResult, CheckId::EarlyStage, suspicious);
+    return suspicious;
+}
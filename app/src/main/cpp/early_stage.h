@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * 库加载时（System.loadLibrary 期间，早于 Java 层初始化）采集的基线
+ * 全部是定长字段，由库构造函数填充一次，之后只读
+ */
+struct EarlyBaseline {
+    static constexpr size_t kMaxThreads = 128;
+    static constexpr size_t kMaxEnviron = 32;
+
+    bool captured;
+    int64_t capturedAtNs;      // CLOCK_MONOTONIC
+    int64_t costNs;            // 整个采集阶段耗时
+
+    int tracerPid;
+
+    // 线程：常驻线程的 tid 升序（不含线程池中会自行退出的工作线程），以及名字带注入器特征的线程数
+    int threadIds[kMaxThreads];
+    size_t threadCount;
+    int injectorThreads;
+
+    // 敏感环境变量：每条 "KEY=VALUE" 的哈希，升序
+    uint64_t environHashes[kMaxEnviron];
+    size_t environCount;
+
+    // 内存映射统计；超出时限时 mapsComplete 为 false，anonExecMappings 不完整，不能用来比较
+    int mapsEntries;
+    int anonExecMappings;
+    int injectorMappings;
+    bool mapsComplete;
+};
+
+/**
+ * 加载时基线；库构造函数没有运行时 captured 为 false
+ */
+const EarlyBaseline& earlyBaseline();
@@ -0,0 +1,154 @@
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unistd.h>
+
+#include "event_log.h"
+#include "proc_snapshot.h"
+
+namespace {
+
+/**
+ * 命中敏感变量后如何判断它的值
+ */
+enum class EnvRule : uint8_t {
+    Present,        // 只要存在且非空就可疑
+    WritablePath,   // 路径列表中出现可写目录才可疑
+    HookClassPath   // 类路径中出现 Hook 框架才可疑
+};
+
+struct EnvKey {
+    const char* name;
+    size_t length;
+    bool prefix;
+    EnvRule rule;
+};
+
+#define ENV_KEY(name, prefix, rule) {name, sizeof(name) - 1, prefix, rule}
+
+const EnvKey kSensitiveKeys[] = {
+        ENV_KEY("LD_PRELOAD", false, EnvRule::Present),
+        ENV_KEY("LD_AUDIT", false, EnvRule::Present),
+        ENV_KEY("LD_LIBRARY_PATH", false, EnvRule::WritablePath),
+        ENV_KEY("CLASSPATH", false, EnvRule::HookClassPath),
+        ENV_KEY("FRIDA_", true, EnvRule::Present),
+        ENV_KEY("ZYGISK_", true, EnvRule::Present),
+        ENV_KEY("RIRU_", true, EnvRule::Present),
+        ENV_KEY("MAGISK", true, EnvRule::Present)
+};
+
+#undef ENV_KEY
+
+const char* const kWritableDirs[] = {
+        "/data/local/tmp",
+        "/data/adb",
+        "/sdcard",
+        "/storage/"
+};
+
+const char* const kHookClassPathKeywords[] = {
+        "xposed",
+        "Xposed",
+        "lspd",
+        "edxp",
+        "riru"
+};
+
+const EnvKey* matchKey(std::string_view key) {
+    for (const EnvKey& candidate : kSensitiveKeys) {
+        if (candidate.prefix ? key.size() >= candidate.length
+                             : key.size() == candidate.length) {
+            if (memcmp(key.data(), candidate.name, candidate.length) == 0) {
+                return &candidate;
+            }
+        }
+    }
+    return nullptr;
+}
+
+bool containsAny(std::string_view value, const char* const* needles, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        if (value.find(needles[i]) != std::string_view::npos) return true;
+    }
+    return false;
+}
+
+bool isSuspiciousValue(const EnvKey& key, std::string_view value) {
+    switch (key.rule) {
+        case EnvRule::Present:
+            return !value.empty();
+        case EnvRule::WritablePath:
+            return containsAny(value, kWritableDirs, sizeof(kWritableDirs) / sizeof(kWritableDirs[0]));
+        case EnvRule::HookClassPath:
+            return containsAny(value, kHookClassPathKeywords,
+                               sizeof(kHookClassPathKeywords) / sizeof(kHookClassPathKeywords[0]));
+    }
+    return false;
+}
+
+/**
+ * 处理一条 "KEY=VALUE"：命中敏感键时记录下来，并返回值是否可疑
+ */
+bool inspectEntry(std::string_view entry, std::vector<std::string_view>& sensitive) {
+    size_t eq = entry.find('=');
+    if (eq == std::string_view::npos) return false;
+
+    const EnvKey* key = matchKey(entry.substr(0, eq));
+    if (key == nullptr) return false;
+
+    sensitive.push_back(entry);
+    if (isSuspiciousValue(*key, entry.substr(eq + 1))) {
+        EVLOG_W(SuspiciousEnvVar, eventlog::intern(entry));
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
+/**
+ * KEY 是否命中敏感键表，供加载时基线只记录这些变量（见 early_stage.cpp）
+ */
+bool isSensitiveEnvironmentKey(std::string_view key) {
+    return matchKey(key) != nullptr;
+}
+
+/**
+ * 检测 Hook：环境变量单次扫描
+ * 一次遍历 environ，用编译期的键表匹配所有敏感变量，不再逐个 getenv；
+ * 再与 /proc/self/environ（进程启动时的环境块）比较，
+ * 注入器加载完成后 unsetenv 掉 LD_PRELOAD 等变量的痕迹会在这里暴露
+ */
+bool checkEnvironment() {
+    bool suspicious = false;
+
+    std::vector<std::string_view> current;
+    for (char** entry = environ; entry != nullptr && *entry != nullptr; entry++) {
+        if (inspectEntry(*entry, current)) suspicious = true;
+    }
+
+    ProcSnapshot& snapshot = currentSnapshot();
+    if (!snapshot.available(ProcFile::Environ)) {
+        return suspicious;
+    }
+
+    std::vector<std::string_view> initial;
+    const std::string& content = snapshot.get(ProcFile::Environ);
+    size_t pos = 0;
+    while (pos < content.size()) {
+        size_t end = content.find('\0', pos);
+        if (end == std::string::npos) end = content.size();
+        if (inspectEntry(std::string_view(content).substr(pos, end - pos), initial)) suspicious = true;
+        pos = end + 1;
+    }
+
+    std::sort(current.begin(), current.end());
+    std::sort(initial.begin(), initial.end());
+    if (current != initial) {
+        EVLOG_W(SensitiveEnvChanged, initial.size(), current.size());
+        suspicious = true;
+    }
+    return suspicious;
+}
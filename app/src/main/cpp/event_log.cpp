@@ -0,0 +1,198 @@
+#include "event_log.h"
+
+#include <jni.h>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <unistd.h>
+
+#include "proc_utils.h"
+#include "timing_probe.h"
+
+namespace {
+
+// 环形缓冲区容量（2 的幂），满了以后覆盖最旧的记录
+constexpr size_t kCapacity = 1024;
+static_assert((kCapacity & (kCapacity - 1)) == 0, "ring capacity must be a power of two");
+
+// 驻留字符串表
+constexpr size_t kMaxStrings = 128;
+constexpr size_t kMaxStringLength = 120;
+
+/**
+ * 一条定长记录
+ * sequence 最后写入：等于 写入序号 + 1 时记录完整，导出时前后各读一次以丢弃正在被覆盖的记录
+ */
+struct EventRecord {
+    std::atomic<uint64_t> sequence;
+    int64_t timestampNs;
+    int64_t args[eventlog::kMaxArgs];
+    uint32_t tid;
+    EventId id;
+    EventLevel level;
+    uint8_t argCount;
+};
+
+const char* const kEventFormats[] = {
+#define EVENT_FORMAT(name, format) format,
+        EVENT_LIST(EVENT_FORMAT)
+#undef EVENT_FORMAT
+};
+
+static_assert(sizeof(kEventFormats) / sizeof(kEventFormats[0]) ==
+              static_cast<size_t>(EventId::Count), "event format table out of sync");
+
+const char* const kCheckNames[] = {
+#define CHECK_NAME(name) #name,
+        CHECK_LIST(CHECK_NAME)
+#undef CHECK_NAME
+};
+
+static_assert(sizeof(kCheckNames) / sizeof(kCheckNames[0]) ==
+              static_cast<size_t>(CheckId::Count), "check name table out of sync");
+
+const char* const kLevelNames[] = {"D", "I", "W"};
+
+EventRecord g_ring[kCapacity];
+std::atomic<uint64_t> g_next{0};
+
+std::mutex g_stringMutex;
+char g_strings[kMaxStrings][kMaxStringLength + 1];
+uint64_t g_stringHashes[kMaxStrings];
+size_t g_stringCount = 0;
+
+uint32_t currentTid() {
+    thread_local uint32_t tid = static_cast<uint32_t>(gettid());
+    return tid;
+}
+
+const char* stringAt(int64_t id) {
+    if (id <= 0 || static_cast<size_t>(id) > kMaxStrings) {
+        return "?";
+    }
+    return g_strings[id - 1];
+}
+
+/**
+ * 按事件表展开一条记录
+ */
+void formatRecord(std::string& out, const EventRecord& record, uint64_t sequence, int64_t baseNs) {
+    char prefix[64];
+    snprintf(prefix, sizeof(prefix), "#%llu +%lld.%03lldms %u %s ",
+             static_cast<unsigned long long>(sequence),
+             static_cast<long long>((record.timestampNs - baseNs) / 1000000),
+             static_cast<long long>((record.timestampNs - baseNs) / 1000 % 1000),
+             record.tid, kLevelNames[static_cast<size_t>(record.level)]);
+    out += prefix;
+
+    size_t arg = 0;
+    for (const char* p = kEventFormats[static_cast<size_t>(record.id)]; *p != '\0'; p++) {
+        const char* close = *p == '{' ? strchr(p, '}') : nullptr;
+        if (close == nullptr) {
+            out += *p;
+            continue;
+        }
+
+        int64_t value = arg < record.argCount ? record.args[arg] : 0;
+        arg++;
+        char spec = close - p == 2 ? p[1] : '\0';
+        if (spec == 'c') {
+            out += static_cast<size_t>(value) < static_cast<size_t>(CheckId::Count) ? kCheckNames[value] : "?";
+        } else if (spec == 'b') {
+            out += value != 0 ? "detected" : "clean";
+        } else if (spec == 's') {
+            out += stringAt(value);
+        } else if (spec == 'x') {
+            char hex[24];
+            snprintf(hex, sizeof(hex), "0x%llx", static_cast<unsigned long long>(value));
+            out += hex;
+        } else {
+            out += std::to_string(value);
+        }
+        p = close;
+    }
+    out += '\n';
+}
+
+} // namespace
+
+namespace eventlog {
+
+uint32_t intern(std::string_view text) {
+    if (text.size() > kMaxStringLength) {
+        text = text.substr(text.size() - kMaxStringLength);
+    }
+    uint64_t hash = fnv1a64(text.data(), text.size());
+
+    std::lock_guard<std::mutex> lock(g_stringMutex);
+    for (size_t i = 0; i < g_stringCount; i++) {
+        if (g_stringHashes[i] == hash && text == g_strings[i]) {
+            return static_cast<uint32_t>(i + 1);
+        }
+    }
+    if (g_stringCount == kMaxStrings) {
+        return 0;
+    }
+    memcpy(g_strings[g_stringCount], text.data(), text.size());
+    g_strings[g_stringCount][text.size()] = '\0';
+    g_stringHashes[g_stringCount] = hash;
+    return static_cast<uint32_t>(++g_stringCount);
+}
+
+void append(EventLevel level, EventId id, const int64_t* args, size_t count) {
+    uint64_t sequence = g_next.fetch_add(1, std::memory_order_relaxed);
+    EventRecord& record = g_ring[sequence & (kCapacity - 1)];
+
+    record.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    record.timestampNs = monotonicNowNs();
+    record.tid = currentTid();
+    record.id = id;
+    record.level = level;
+    record.argCount = static_cast<uint8_t>(count);
+    for (size_t i = 0; i < count; i++) {
+        record.args[i] = args[i];
+    }
+    record.sequence.store(sequence + 1, std::memory_order_release);
+}
+
+std::string dump() {
+    uint64_t end = g_next.load(std::memory_order_acquire);
+    uint64_t begin = end > kCapacity ? end - kCapacity : 0;
+
+    std::string out;
+    out.reserve(static_cast<size_t>(end - begin) * 64);
+    int64_t baseNs = 0;
+    for (uint64_t sequence = begin; sequence < end; sequence++) {
+        const EventRecord& slot = g_ring[sequence & (kCapacity - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != sequence + 1) continue;
+
+        EventRecord copy;
+        copy.timestampNs = slot.timestampNs;
+        copy.tid = slot.tid;
+        copy.id = slot.id;
+        copy.level = slot.level;
+        copy.argCount = slot.argCount;
+        memcpy(copy.args, slot.args, sizeof(copy.args));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != sequence + 1) continue;
+
+        if (baseNs == 0) baseNs = copy.timestampNs;
+        formatRecord(out, copy, sequence, baseNs);
+    }
+    return out;
+}
+
+} // namespace eventlog
+
+/**
+ * 导出事件日志文本，附在问题报告中
+ */
+extern "C"
+JNIEXPORT jstring JNICALL
+Java_com_grtsinry43_environmentdetector_security_NativeSecurityDetector_nativeDumpEventLog(
+        JNIEnv* env,
+        jclass clazz) {
+    return env->NewStringUTF(eventlog::dump().c_str());
+}
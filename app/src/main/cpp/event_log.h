@@ -0,0 +1,172 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "native_api.h"
+
+NATIVE_API_BEGIN
+
+/**
+ * 结构化二进制事件日志
+ * 扫描路径上不再调用 __android_log_print（每条一次 logd 套接字写入，还会把检测细节暴露在 logcat），
+ * 而是把定长记录（事件 id、参数、时间戳）写进进程内的环形缓冲区，格式化推迟到导出时进行；
+ * 低于编译期级别 EVENT_LOG_LEVEL 的调用点整体展开为空语句，参数也不会求值
+ */
+
+#define EVENT_LEVEL_DEBUG 0
+#define EVENT_LEVEL_INFO 1
+#define EVENT_LEVEL_WARN 2
+#define EVENT_LEVEL_OFF 3
+
+#ifndef EVENT_LOG_LEVEL
+#define EVENT_LOG_LEVEL EVENT_LEVEL_DEBUG
+#endif
+
+enum class EventLevel : uint8_t {
+    Debug = EVENT_LEVEL_DEBUG,
+    Info = EVENT_LEVEL_INFO,
+    Warn = EVENT_LEVEL_WARN
+};
+
+/**
+ * 事件表：id 与导出时使用的格式
+ * 占位符依次消耗参数：{} 整数，{x} 十六进制整数（地址、偏移），{c} 检测项名，{b} 检测结果，{s} 驻留字符串
+ */
+#define EVENT_LIST(X) \
+    X(CheckStarted, "{c} started") \
+    X(CheckResult, "{c} result: {b}") \
+    X(CallVerificationFailed, "call verification failed, possible SO hijacking") \
+    X(TracerPid, "TracerPid {}") \
+    X(FridaThread, "Frida thread {s}") \
+    X(FridaMapping, "Frida signature in maps {s}") \
+    X(SuspiciousLibrary, "suspicious library {s} at {s}") \
+    X(MonitorRiskChanged, "monitor risk mask {} -> {}, next interval {}ms") \
+    X(SuspiciousFd, "fd {} refers to {s}") \
+    X(InjectorUnixSocket, "unix socket to {s}") \
+    X(FridaTcpSocket, "TCP socket on Frida port {s} -> {s}") \
+    X(ForeignPackageCode, "foreign package code mapped {s}") \
+    X(SuspiciousSignalHandler, "suspicious handler for signal {} in {s} ({s})") \
+    X(InjectorThreadAtLoad, "injector thread present at load {s}") \
+    X(InjectorLibraryAtLoad, "injector library mapped at load {s}") \
+    X(ThreadsVanishedSinceLoad, "{} threads present at load have exited, first tid {}") \
+    X(AnonExecGrowthSinceLoad, "anonymous executable mappings grew from {} at load to {}") \
+    X(UnlinkedExecMapping, "executable mapping unknown to linker {s} @ {x}") \
+    X(PhantomLinkerObject, "linker object without backing mapping {s} @ {x}") \
+    X(ModifiedCodePage, "modified code page in {s} at offset {x}") \
+    X(CodeBreakpoints, "breakpoints planted in own code page {x}: {} (file {})") \
+    X(OwnCodeModified, "own code page {x} differs from file") \
+    X(OwnCodePages, "own code pages {}, with breakpoints {}, modified {}") \
+    X(PatchedFunction, "function {x} patched (breakpoints in window {}, file {})") \
+    X(HookedArtMethod, "hooked ArtMethod {x}: entry in {s} ({s})") \
+    X(ArtMethodFlagsChanged, "ArtMethod {x} access flags {x} -> {x}") \
+    X(ForeignJniFunction, "JNI function table entry {x} in {s} ({s})") \
+    X(MapsViewMismatch, "mapping views disagree on {x}-{x}") \
+    X(HiddenRegion, "memory region hidden from maps {x}-{x}") \
+    X(GapProbeSuspended, "gap probe budget exhausted, resuming at {x}") \
+    X(GapProbePassCompleted, "gap probe pass {} completed, {} probes left") \
+    X(SuspiciousEnvVar, "suspicious environment variable {s}") \
+    X(SensitiveEnvChanged, "sensitive environment changed after start: {} initial, {} current") \
+    X(DbusResponder, "D-Bus AUTH handshake answered on local port {}") \
+    X(DbusProbeSummary, "probed {} local listeners in {}us, D-Bus responders {}")
+
+enum class EventId : uint16_t {
+#define EVENT_ENUM(name, format) name,
+    EVENT_LIST(EVENT_ENUM)
+#undef EVENT_ENUM
+    Count
+};
+
+/**
+ * 检测项，对应各个 JNI 入口
+ */
+#define CHECK_LIST(X) \
+    X(Root) \
+    X(Hook) \
+    X(Debugger) \
+    X(Emulator) \
+    X(ArtMethods) \
+    X(CodeBreakpoints) \
+    X(DbusListeners) \
+    X(DirtyPages) \
+    X(EarlyStage) \
+    X(FileDescriptors) \
+    X(HiddenRegions) \
+    X(CallLatency) \
+    X(ProcessLineage) \
+    X(LinkerConsistency) \
+    X(MapsConsistency) \
+    X(Monitor) \
+    X(MountNamespace) \
+    X(VirtualEnvironment) \
+    X(SignalHandlers) \
+    X(TimingProfile) \
+    X(VirtualApp)
+
+enum class CheckId : uint16_t {
+#define CHECK_ENUM(name) name,
+    CHECK_LIST(CHECK_ENUM)
+#undef CHECK_ENUM
+    Count
+};
+
+namespace eventlog {
+
+constexpr size_t kMaxArgs = 3;
+
+/**
+ * 把字符串驻留到固定大小的表中，返回可作为 {s} 参数的 id；表满时返回 0
+ * 只在命中可疑项等少见路径上使用
+ */
+uint32_t intern(std::string_view text);
+
+/**
+ * 追加一条记录：一次原子自增加上定长写入，不加锁、不分配
+ */
+void append(EventLevel level, EventId id, const int64_t* args, size_t count);
+
+/**
+ * 按时间顺序格式化缓冲区中仍然保留的全部记录，用于问题报告
+ */
+std::string dump();
+
+template <typename T>
+constexpr int64_t toArg(T value) {
+    if constexpr (std::is_enum_v<T>) {
+        return static_cast<int64_t>(static_cast<std::underlying_type_t<T>>(value));
+    } else {
+        return static_cast<int64_t>(value);
+    }
+}
+
+template <typename... Args>
+inline void emit(EventLevel level, EventId id, Args... args) {
+    static_assert(sizeof...(Args) <= kMaxArgs, "too many event arguments");
+    const int64_t values[] = {toArg(args)..., 0};
+    append(level, id, values, sizeof...(Args));
+}
+
+} // namespace eventlog
+
+#if EVENT_LOG_LEVEL <= EVENT_LEVEL_DEBUG
+#define EVLOG_D(id, ...) eventlog::emit(EventLevel::Debug, EventId::id, ##__VA_ARGS__)
+#else
+#define EVLOG_D(id, ...) ((void) 0)
+#endif
+
+#if EVENT_LOG_LEVEL <= EVENT_LEVEL_INFO
+#define EVLOG_I(id, ...) eventlog::emit(EventLevel::Info, EventId::id, ##__VA_ARGS__)
+#else
+#define EVLOG_I(id, ...) ((void) 0)
+#endif
+
+#if EVENT_LOG_LEVEL <= EVENT_LEVEL_WARN
+#define EVLOG_W(id, ...) eventlog::emit(EventLevel::Warn, EventId::id, ##__VA_ARGS__)
+#else
+#define EVLOG_W(id, ...) ((void) 0)
+#endif
+
+NATIVE_API_END
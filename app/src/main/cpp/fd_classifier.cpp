@@ -0,0 +1,271 @@
+#include <jni.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+#include <android/log.h>
+
+#include "event_log.h"
+#include "baseline_store.h"
+#include "proc_utils.h"
+#include "sys_io.h"
+
+#define LOG_TAG "FdClassifier"
+#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN, LOG_TAG, __VA_ARGS__)
+
+namespace {
+
+// 参与套接字表反查的 socket 数量上限（栈上数组）
+constexpr size_t kMaxTrackedSockets = 512;
+
+// frida-server 默认监听端口
+constexpr unsigned kFridaPorts[] = {27042, 27043};
+
+/**
+ * fd 的类别，由 /proc/self/fd/N 链接目标的格式决定
+ */
+enum class FdKind : uint8_t {
+    File,
+    Socket,     // socket:[inode]
+    Pipe,       // pipe:[inode]
+    AnonInode,  // anon_inode:[eventfd] 等
+    Memfd,      // /memfd:name (deleted)
+    Ashmem,     // /dev/ashmem
+    TempFile,   // /data/local/tmp 下的文件或 FIFO，应用本身无权访问
+    Count
+};
+
+const char* const kFdKindNames[] = {
+        "file",
+        "socket",
+        "pipe",
+        "anon_inode",
+        "memfd",
+        "ashmem",
+        "tmp"
+};
+
+static_assert(sizeof(kFdKindNames) / sizeof(kFdKindNames[0]) ==
+              static_cast<size_t>(FdKind::Count), "FdKind name table out of sync");
+
+// Frida 注入器与 agent 留下的名字：linjector FIFO、agent memfd、抽象套接字
+const char* const kInjectorNames[] = {
+        "frida",
+        "linjector",
+        "gum-js",
+        "gadget"
+};
+
+/**
+ * 一次扫描的统计，全部在栈上
+ */
+struct FdTable {
+    int counts[static_cast<size_t>(FdKind::Count)];
+    int suspicious;
+    uint64_t socketInodes[kMaxTrackedSockets];
+    size_t socketCount;
+};
+
+bool hasInjectorName(std::string_view text) {
+    for (const char* name : kInjectorNames) {
+        if (text.find(name) != std::string_view::npos) return true;
+    }
+    return false;
+}
+
+bool startsWith(std::string_view text, const char* prefix) {
+    size_t len = strlen(prefix);
+    return text.size() >= len && text.compare(0, len, prefix) == 0;
+}
+
+/**
+ * 解析 "type:[inode]" 中的 inode
+ */
+uint64_t bracketInode(std::string_view link) {
+    size_t open = link.find('[');
+    uint64_t inode = 0;
+    for (size_t i = open + 1; open != std::string_view::npos && i < link.size() && link[i] != ']'; i++) {
+        inode = inode * 10 + static_cast<uint64_t>(link[i] - '0');
+    }
+    return inode;
+}
+
+FdKind classifyLink(std::string_view link) {
+    if (startsWith(link, "socket:[")) return FdKind::Socket;
+    if (startsWith(link, "pipe:[")) return FdKind::Pipe;
+    if (startsWith(link, "anon_inode:")) return FdKind::AnonInode;
+    if (startsWith(link, "/memfd:")) return FdKind::Memfd;
+    if (startsWith(link, "/dev/ashmem")) return FdKind::Ashmem;
+    if (startsWith(link, "/data/local/tmp/")) return FdKind::TempFile;
+    return FdKind::File;
+}
+
+void classifyFd(FdTable& table, int dirFd, const char* name) {
+    char target[256];
+    ssize_t n = sysio::readlinkat(dirFd, name, target, sizeof(target));
+    if (n <= 0) return;
+
+    std::string_view link(target, static_cast<size_t>(n));
+    FdKind kind = classifyLink(link);
+    table.counts[static_cast<size_t>(kind)]++;
+
+    switch (kind) {
+        case FdKind::Socket:
+            if (table.socketCount < kMaxTrackedSockets) {
+                table.socketInodes[table.socketCount++] = bracketInode(link);
+            }
+            break;
+        case FdKind::TempFile:
+            table.suspicious++;
+            EVLOG_W(SuspiciousFd, atoi(name), eventlog::intern(link));
+            break;
+        case FdKind::Memfd:
+        case FdKind::File:
+            if (hasInjectorName(link)) {
+                table.suspicious++;
+                EVLOG_W(SuspiciousFd, atoi(name), eventlog::intern(link));
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * 取一行中第 index 个以空白分隔的字段
+ */
+std::string_view fieldAt(const char* line, size_t len, int index, bool toEnd = false) {
+    size_t pos = 0;
+    for (int field = 0; pos < len; field++) {
+        while (pos < len && line[pos] == ' ') pos++;
+        size_t start = pos;
+        while (pos < len && line[pos] != ' ') pos++;
+        if (field == index) {
+            return std::string_view(line + start, (toEnd ? len : pos) - start);
+        }
+    }
+    return {};
+}
+
+uint64_t parseNumber(std::string_view text, int base) {
+    uint64_t value = 0;
+    for (char c : text) {
+        int digit;
+        if (c >= '0' && c <= '9') digit = c - '0';
+        else if (base == 16 && c >= 'A' && c <= 'F') digit = c - 'A' + 10;
+        else if (base == 16 && c >= 'a' && c <= 'f') digit = c - 'a' + 10;
+        else break;
+        value = value * static_cast<uint64_t>(base) + static_cast<uint64_t>(digit);
+    }
+    return value;
+}
+
+bool ownsSocket(const FdTable& table, uint64_t inode) {
+    return std::binary_search(table.socketInodes, table.socketInodes + table.socketCount, inode);
+}
+
+/**
+ * /proc/net/unix：Num RefCount Protocol Flags Type St Inode Path
+ */
+int countInjectorUnixSockets(const FdTable& table) {
+    int found = 0;
+    forEachLine("/proc/net/unix", [&table, &found](const char* line, size_t len) {
+        std::string_view path = fieldAt(line, len, 7, true);
+        if (path.empty() || !hasInjectorName(path)) return true;
+        if (ownsSocket(table, parseNumber(fieldAt(line, len, 6), 10))) {
+            found++;
+            EVLOG_W(InjectorUnixSocket, eventlog::intern(path));
+        }
+        return true;
+    });
+    return found;
+}
+
+bool isFridaPort(std::string_view address) {
+    size_t colon = address.find(':');
+    if (colon == std::string_view::npos) return false;
+    auto port = static_cast<unsigned>(parseNumber(address.substr(colon + 1), 16));
+    for (unsigned fridaPort : kFridaPorts) {
+        if (port == fridaPort) return true;
+    }
+    return false;
+}
+
+/**
+ * /proc/net/tcp{,6}：sl local rem st tx:rx tr:when retrnsmt uid timeout inode
+ */
+int countFridaTcpSockets(const FdTable& table, const char* path) {
+    int found = 0;
+    forEachLine(path, [&table, &found](const char* line, size_t len) {
+        std::string_view local = fieldAt(line, len, 1);
+        std::string_view remote = fieldAt(line, len, 2);
+        if (!isFridaPort(local) && !isFridaPort(remote)) return true;
+        if (ownsSocket(table, parseNumber(fieldAt(line, len, 9), 10))) {
+            found++;
+            EVLOG_W(FridaTcpSocket, eventlog::intern(local), eventlog::intern(remote));
+        }
+        return true;
+    });
+    return found;
+}
+
+} // namespace
+
+/**
+ * 检测 Hook：文件描述符表分类
+ * getdents64 枚举 /proc/self/fd，相对目录 fd 逐个 readlinkat 到栈缓冲区并按链接格式分类；
+ * 套接字再按 inode 反查 /proc/net 的套接字表。只对注入器留下的具体痕迹报警
+ * （/data/local/tmp 下的 linjector FIFO、frida 命名的 memfd/套接字、连到 Frida 端口的 TCP），
+ * fd 总数只与本设备的历史基线比较（见 baseline_store.h）；整个过程不分配堆内存
+ */
+bool checkFileDescriptors() {
+    int dirFd = sysio::openat(AT_FDCWD, "/proc/self/fd", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirFd < 0) {
+        return false;
+    }
+
+    FdTable table{};
+    forEachDirEntry(dirFd, [&table, dirFd](const sysio::Dirent64& entry) {
+        classifyFd(table, dirFd, entry.d_name);
+        return true;
+    });
+    sysio::close(dirFd);
+
+    // Android 10 起 /proc/net 对应用受限，读取失败时只依据链接本身
+    std::sort(table.socketInodes, table.socketInodes + table.socketCount);
+    if (table.socketCount > 0) {
+        table.suspicious += countInjectorUnixSockets(table);
+        table.suspicious += countFridaTcpSockets(table, "/proc/net/tcp");
+        table.suspicious += countFridaTcpSockets(table, "/proc/net/tcp6");
+    }
+
+    int total = 0;
+    for (size_t kind = 0; kind < static_cast<size_t>(FdKind::Count); kind++) {
+        if (table.counts[kind] > 0) {
+            LOGD("fd kind %s: %d", kFdKindNames[kind], table.counts[kind]);
+        }
+        total += table.counts[kind];
+    }
+
+    // fd 总数只和本设备的历史比较，没有全局阈值
+    if (observeMetric(Metric::FdCount, total) == MetricVerdict::Anomalous) {
+        LOGW("fd count %d far above this device's history", total);
+        table.suspicious++;
+    }
+    return table.suspicious > 0;
+}
+
+extern "C"
+JNIEXPORT jboolean JNICALL
+Java_com_grtsinry43_environmentdetector_security_NativeSecurityDetector_nativeCheckFileDescriptors(
+        JNIEnv* env,
+        jclass clazz) {
+
+    EVLOG_D(CheckStarted, CheckId::FileDescriptors);
+
+    bool suspicious = checkFileDescriptors();
+
+    EVLOG_I(CheckResult, CheckId::FileDescriptors, suspicious);
+    return suspicious;
+}
@@ -0,0 +1,267 @@
+#include <jni.h>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "event_log.h"
+#include "monitor.h"
+#include "proc_snapshot.h"
+#include "proc_utils.h"
+
+namespace {
+
+// 每次调用最多发起的 mincore 次数，剩余的间隙留给下一次调用
+constexpr int kMaxProbesPerTick = 256;
+
+// 重新读取并解析一次 maps 折算的探测次数，同样从预算中扣除
+constexpr int kMapsRecheckCost = 32;
+
+// 最低可映射地址（mmap_min_addr 在 Android 上为 32KB 或 64KB），第一个映射之下的间隙从这里开始
+constexpr uintptr_t kLowestMappableAddress = 0x10000;
+
+/**
+ * 跨调用保存的进度：下一次从起始地址不小于 resumeAddress 的间隙继续
+ */
+struct GapProbeState {
+    uintptr_t resumeAddress = 0;
+    unsigned completedPasses = 0;
+};
+
+// 进度游标跨线程共享，每次推进都在锁内完成
+std::mutex g_probeMutex;
+GapProbeState g_probeState;
+
+struct ProbeBudget {
+    int remaining = kMaxProbesPerTick;
+};
+
+/**
+ * 探测单页是否有映射
+ * mincore 只检查起始地址所在的 vma，所以一次调用只能可靠地回答一页；
+ * 未映射返回 ENOMEM，有映射（无论是否驻留）返回 0
+ */
+bool isPageMapped(uintptr_t addr, size_t pageSize, ProbeBudget& budget) {
+    budget.remaining--;
+    unsigned char residency = 0;
+    return mincore(reinterpret_cast<void*>(addr), pageSize, &residency) == 0;
+}
+
+/**
+ * 二分细化：已知 low 未映射、high 有映射，找出第一页有映射的地址
+ */
+uintptr_t refineLowerBound(uintptr_t low, uintptr_t high, size_t pageSize, ProbeBudget& budget) {
+    while (high - low > pageSize && budget.remaining > 0) {
+        uintptr_t mid = low + ((high - low) / pageSize / 2) * pageSize;
+        if (isPageMapped(mid, pageSize, budget)) {
+            high = mid;
+        } else {
+            low = mid;
+        }
+    }
+    return high;
+}
+
+/**
+ * 从已命中的页向上倍增再二分，找出隐藏区域的结束地址
+ */
+uintptr_t refineUpperBound(uintptr_t hit, uintptr_t limit, size_t pageSize, ProbeBudget& budget) {
+    uintptr_t mapped = hit;
+    uintptr_t step = pageSize;
+    uintptr_t unmapped = limit;
+    while (budget.remaining > 0 && mapped + step < limit) {
+        if (!isPageMapped(mapped + step, pageSize, budget)) {
+            unmapped = mapped + step;
+            break;
+        }
+        mapped += step;
+        step *= 2;
+    }
+    while (unmapped - mapped > pageSize && budget.remaining > 0) {
+        uintptr_t mid = mapped + ((unmapped - mapped) / pageSize / 2) * pageSize;
+        if (isPageMapped(mid, pageSize, budget)) {
+            mapped = mid;
+        } else {
+            unmapped = mid;
+        }
+    }
+    return mapped + pageSize;
+}
+
+/**
+ * 在一个间隙内从两端按指数步长探测
+ * 注入的区域通常紧贴已有映射分配，所以靠近边缘处探测最密
+ * 返回 true 表示找到了映射，hiddenStart/hiddenEnd 为细化后的范围
+ */
+bool probeGap(uintptr_t gapStart, uintptr_t gapEnd, size_t pageSize, ProbeBudget& budget,
+              uintptr_t& hiddenStart, uintptr_t& hiddenEnd) {
+    uintptr_t gapPages = (gapEnd - gapStart) / pageSize;
+    uintptr_t lastLow = gapStart - pageSize;
+
+    for (uintptr_t offset = 0; offset < (gapPages + 1) / 2; offset = offset == 0 ? 1 : offset * 2) {
+        if (budget.remaining <= 0) return false;
+
+        uintptr_t low = gapStart + offset * pageSize;
+        if (isPageMapped(low, pageSize, budget)) {
+            hiddenStart = refineLowerBound(lastLow, low, pageSize, budget);
+            hiddenEnd = refineUpperBound(low, gapEnd, pageSize, budget);
+            return true;
+        }
+        lastLow = low;
+
+        uintptr_t high = gapEnd - (offset + 1) * pageSize;
+        if (high > low && isPageMapped(high, pageSize, budget)) {
+            hiddenStart = refineLowerBound(low, high, pageSize, budget);
+            hiddenEnd = refineUpperBound(high, gapEnd, pageSize, budget);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * 用于排除竞争的新 maps：每次调用最多读取一次，读取计入探测预算
+ */
+struct FreshMaps {
+    bool loaded = false;
+    bool available = false;
+    MapsSnapshot maps;
+};
+
+/**
+ * 命中可能只是快照之后新建的映射，用新读取的 maps 排除竞争
+ */
+bool isReallyHidden(uintptr_t start, uintptr_t end, size_t pageSize, FreshMaps& fresh, ProbeBudget& budget) {
+    if (!fresh.loaded) {
+        fresh.loaded = true;
+        budget.remaining -= kMapsRecheckCost;
+        std::string content;
+        if (readFileFully("/proc/self/maps", content)) {
+            fresh.maps.parse(content);
+            fresh.available = true;
+        }
+    }
+    if (!fresh.available) {
+        return false;
+    }
+
+    // 抽查区域的首页、中间页和末页
+    const uintptr_t samples[] = {
+            start,
+            start + ((end - start) / pageSize / 2) * pageSize,
+            end - pageSize
+    };
+    for (uintptr_t addr : samples) {
+        if (fresh.maps.find(addr) != nullptr) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * 用户地址空间上界的估计：最高映射向上取到 2 的幂（39、47、48 位地址空间等）
+ */
+uintptr_t addressSpaceTop(uintptr_t highest, size_t pageSize) {
+    uintptr_t top = pageSize;
+    while (top != 0 && top < highest) top <<= 1;
+    return top != 0 ? top : static_cast<uintptr_t>(0) - pageSize;
+}
+
+/**
+ * 第 index 个间隙：0 为第一个映射之下，entries.size() 为最后一个映射之上，其余为相邻映射之间
+ */
+void gapAt(const std::vector<MapEntry>& entries, size_t index, uintptr_t top,
+           uintptr_t& gapStart, uintptr_t& gapEnd) {
+    gapStart = index == 0 ? kLowestMappableAddress : entries[index - 1].end;
+    gapEnd = index == entries.size() ? top : entries[index].start;
+}
+
+} // namespace
+
+/**
+ * 检测 Hook：在 maps 报告的映射间隙中寻找被隐藏的内存区域
+ * 高级隐藏手段会过滤对 maps 的 read()，注入的区域在文本扫描中永远不会出现，
+ * 但内核的 vma 仍然存在，mincore 可以直接探测到
+ * 除了相邻映射之间，也探测第一个映射之下和最后一个映射之上的空间
+ * 每次调用受探测次数上限约束，未完成的间隙由下一次调用继续
+ */
+bool probeHiddenRegions() {
+    const MapsSnapshot& maps = currentSnapshot().maps();
+    const std::vector<MapEntry>& entries = maps.entries();
+    if (entries.size() < 2) {
+        return false;
+    }
+
+    size_t pageSize = static_cast<size_t>(getpagesize());
+    uintptr_t top = addressSpaceTop(entries.back().end, pageSize);
+    size_t gapCount = entries.size() + 1;
+    ProbeBudget budget;
+    FreshMaps fresh;
+    bool detected = false;
+
+    std::lock_guard<std::mutex> lock(g_probeMutex);
+
+    size_t i = 0;
+    uintptr_t gapStart = 0;
+    uintptr_t gapEnd = 0;
+    for (; i < gapCount; i++) {
+        gapAt(entries, i, top, gapStart, gapEnd);
+        if (gapStart >= g_probeState.resumeAddress) break;
+    }
+
+    for (; i < gapCount; i++) {
+        gapAt(entries, i, top, gapStart, gapEnd);
+        if (gapEnd <= gapStart) continue;
+
+        if (budget.remaining <= 0) {
+            g_probeState.resumeAddress = gapStart;
+            EVLOG_D(GapProbeSuspended, gapStart);
+            return detected;
+        }
+
+        uintptr_t hiddenStart = 0;
+        uintptr_t hiddenEnd = 0;
+        bool hit = probeGap(gapStart, gapEnd, pageSize, budget, hiddenStart, hiddenEnd);
+        if (!hit && budget.remaining <= 0) {
+            // 这个间隙没有探测完，下次从它重新开始
+            g_probeState.resumeAddress = gapStart;
+            return detected;
+        }
+        if (hit && isReallyHidden(hiddenStart, hiddenEnd, pageSize, fresh, budget)) {
+            EVLOG_W(HiddenRegion, hiddenStart, hiddenEnd);
+            detected = true;
+        }
+    }
+
+    // 一整轮结束，下次从头开始
+    g_probeState.resumeAddress = 0;
+    g_probeState.completedPasses++;
+    EVLOG_D(GapProbePassCompleted, g_probeState.completedPasses, budget.remaining);
+    return detected;
+}
+
+extern "C"
+JNIEXPORT jboolean JNICALL
+Java_com_grtsinry43_environmentdetector_security_NativeSecurityDetector_nativeProbeHiddenRegions(
+        JNIEnv* env,
+        jclass clazz) {
+
+    EVLOG_D(CheckStarted, CheckId::HiddenRegions);
+
+    bool detected = probeHiddenRegions();
+
+    EVLOG_I(CheckResult, CheckId::HiddenRegions, detected);
+    return detected;
+}
+
+/**
+ * 内存扫描模块（libscanner_memory.so）的加载入口
+ * 每次调用只做少量 mincore 的间隙探测适合周期执行，模块加载后加入后台监控
+ */
+extern "C"
+JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM* vm, void* reserved) {
+    registerMonitorCheck("hidden regions", probeHiddenRegions);
+    return JNI_VERSION_1_6;
+}
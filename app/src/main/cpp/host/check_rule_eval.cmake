@@ -0,0 +1,36 @@
+# rule_eval 夹具回归（ctest 通过 cmake -P 运行）
+# 重放 testdata/corpus 并比较命中矩阵与汇总表，回放路径重写或标签计分出错时失败
+#
+# 参数：RULE_EVAL 可执行文件、CORPUS 夹具目录、EXPECTED_DIR 期望输出目录、OUTPUT_DIR 输出目录
+
+foreach(var RULE_EVAL CORPUS EXPECTED_DIR OUTPUT_DIR)
+    if(NOT DEFINED ${var})
+        message(FATAL_ERROR "${var} is not set")
+    endif()
+endforeach()
+
+set(matrix ${OUTPUT_DIR}/rule_eval_matrix.csv)
+file(REMOVE ${matrix})
+
+execute_process(
+        COMMAND ${RULE_EVAL} -j 2 -o ${matrix} ${CORPUS}
+        OUTPUT_VARIABLE summary
+        RESULT_VARIABLE result
+)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "rule_eval exited with ${result}\n${summary}")
+endif()
+
+# 第一行是耗时统计，每次运行都不同
+string(REGEX REPLACE "^Replayed[^\n]*\n\n" "" summary "${summary}")
+
+file(READ ${EXPECTED_DIR}/expected_matrix.csv expected_matrix)
+file(READ ${matrix} actual_matrix)
+if(NOT actual_matrix STREQUAL expected_matrix)
+    message(FATAL_ERROR "hit matrix differs\nexpected:\n${expected_matrix}\nactual:\n${actual_matrix}")
+endif()
+
+file(READ ${EXPECTED_DIR}/expected_summary.txt expected_summary)
+if(NOT summary STREQUAL expected_summary)
+    message(FATAL_ERROR "summary differs\nexpected:\n${expected_summary}\nactual:\n${summary}")
+endif()
@@ -0,0 +1,166 @@
+/**
+ * D-Bus 握手探测的主机自检（ctest 运行）
+ * 在回环地址上启动假的服务端，让 probeDbusListeners 读取本机真实的 /proc/net/tcp{,6} 并发起探测：
+ *   - 普通服务端（回复 HTTP 错误）不应被判定为 D-Bus
+ *   - 假的 D-Bus 服务端（收到 AUTH 回复 REJECTED，与 frida-server 相同）必须被识别
+ *   - IPv4 上是普通服务、IPv6 上同一端口号是 D-Bus 服务时，两者都要探测
+ * 本机其它进程的监听端口也会被探测，自检只要求不存在其它 D-Bus 应答者
+ *
+ * 用法：dbus_probe_check [-v]
+ */
+
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <android/log.h>
+
+#include "host_shims.h"
+
+// 外部声明被测的探测入口
+extern bool probeDbusListeners();
+
+namespace {
+
+constexpr char kDbusReply[] = "REJECTED EXTERNAL\r\n";
+constexpr char kPlainReply[] = "HTTP/1.0 400 Bad Request\r\n\r\n";
+
+/**
+ * 回环地址上的单个监听套接字，后台线程对每个连接读一次请求后回复固定内容
+ */
+class FakeServer {
+public:
+    FakeServer(int family, uint16_t port, const char* reply) : reply_(reply) {
+        fd_ = socket(family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd_ < 0) return;
+
+        int one = 1;
+        setsockopt(fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        int rc;
+        if (family == AF_INET6) {
+            setsockopt(fd_, IPPROTO_IPV6, IPV6_V6ONLY, &one, sizeof(one));
+            struct sockaddr_in6 addr{};
+            addr.sin6_family = AF_INET6;
+            addr.sin6_port = htons(port);
+            addr.sin6_addr = in6addr_loopback;
+            rc = bind(fd_, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr));
+        } else {
+            struct sockaddr_in addr{};
+            addr.sin_family = AF_INET;
+            addr.sin_port = htons(port);
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            rc = bind(fd_, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr));
+        }
+        if (rc != 0 || listen(fd_, 8) != 0) {
+            close(fd_);
+            fd_ = -1;
+            return;
+        }
+
+        struct sockaddr_storage bound{};
+        socklen_t len = sizeof(bound);
+        getsockname(fd_, reinterpret_cast<struct sockaddr*>(&bound), &len);
+        port_ = ntohs(family == AF_INET6 ? reinterpret_cast<struct sockaddr_in6*>(&bound)->sin6_port
+                                         : reinterpret_cast<struct sockaddr_in*>(&bound)->sin_port);
+        thread_ = std::thread([this] { serve(); });
+    }
+
+    ~FakeServer() {
+        stop_.store(true);
+        if (thread_.joinable()) thread_.join();
+        if (fd_ >= 0) close(fd_);
+    }
+
+    FakeServer(const FakeServer&) = delete;
+    FakeServer& operator=(const FakeServer&) = delete;
+
+    bool ok() const { return fd_ >= 0; }
+
+    uint16_t port() const { return port_; }
+
+private:
+    void serve() {
+        while (!stop_.load()) {
+            struct pollfd pfd{fd_, POLLIN, 0};
+            if (poll(&pfd, 1, 10) <= 0) continue;
+            int client = accept4(fd_, nullptr, nullptr, SOCK_CLOEXEC);
+            if (client < 0) continue;
+
+            // 探测方先发 '\0' 再发 AUTH，对方关闭或超时前读到任何数据就回复
+            struct pollfd cpfd{client, POLLIN, 0};
+            char request[64];
+            if (poll(&cpfd, 1, 100) > 0 && recv(client, request, sizeof(request), 0) > 0) {
+                send(client, reply_, strlen(reply_), MSG_NOSIGNAL);
+            }
+            close(client);
+        }
+    }
+
+    const char* reply_;
+    int fd_ = -1;
+    uint16_t port_ = 0;
+    std::atomic<bool> stop_{false};
+    std::thread thread_;
+};
+
+int g_failures = 0;
+
+void expect(const char* name, bool expected) {
+    bool detected = probeDbusListeners();
+    bool pass = detected == expected;
+    printf("%-40s %s (detected=%d)\n", name, pass ? "ok" : "FAIL", detected);
+    if (!pass) g_failures++;
+}
+
+bool hasIpv6Loopback() {
+    int fd = socket(AF_INET6, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return false;
+    struct sockaddr_in6 addr{};
+    addr.sin6_family = AF_INET6;
+    addr.sin6_addr = in6addr_loopback;
+    bool ok = bind(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == 0;
+    close(fd);
+    return ok;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    setHostLogPriority(argc > 1 && strcmp(argv[1], "-v") == 0 ? ANDROID_LOG_DEBUG : ANDROID_LOG_SILENT);
+
+    {
+        FakeServer plain(AF_INET, 0, kPlainReply);
+        if (!plain.ok()) {
+            fprintf(stderr, "cannot listen on 127.0.0.1: %s\n", strerror(errno));
+            return 1;
+        }
+        expect("plain listener only", false);
+    }
+
+    {
+        FakeServer dbus(AF_INET, 0, kDbusReply);
+        FakeServer plain(AF_INET, 0, kPlainReply);
+        expect("D-Bus responder on IPv4", true);
+    }
+
+    if (hasIpv6Loopback()) {
+        // 先在 IPv4 上拿到一个普通服务的端口，再在 IPv6 的同一端口号上放 D-Bus 服务
+        FakeServer plain(AF_INET, 0, kPlainReply);
+        FakeServer dbus(AF_INET6, plain.port(), kDbusReply);
+        if (dbus.ok()) {
+            expect("D-Bus on IPv6 sharing a port number", true);
+        } else {
+            printf("%-40s skipped (port %u busy on ::1)\n", "D-Bus on IPv6 sharing a port number", plain.port());
+        }
+    } else {
+        printf("%-40s skipped (no IPv6 loopback)\n", "D-Bus on IPv6 sharing a port number");
+    }
+
+    return g_failures == 0 ? 0 : 1;
+}
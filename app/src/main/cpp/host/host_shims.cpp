@@ -0,0 +1,94 @@
+#include "host_shims.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <android/log.h>
+#include <sys/system_properties.h>
+
+#include "proc_utils.h"
+#include "sys_io.h"
+
+namespace {
+
+std::atomic<int> g_logPriority{ANDROID_LOG_SILENT};
+
+/**
+ * 每个线程缓存当前回放目录的属性表，换目录时重新解析
+ */
+struct PropertyCache {
+    std::string root;
+    std::unordered_map<std::string, std::string> values;
+};
+
+thread_local PropertyCache t_properties;
+
+/**
+ * 解析 getprop 输出："[key]: [value]"，每行一项
+ */
+void parseProperties(const char* path, std::unordered_map<std::string, std::string>& values) {
+    forEachLine(path, [&values](const char* line, size_t len) {
+        std::string_view text(line, len);
+        size_t keyEnd = text.find("]: [");
+        if (text.size() < 6 || text.front() != '[' || text.back() != ']' || keyEnd == std::string_view::npos) {
+            return true;
+        }
+        std::string_view key = text.substr(1, keyEnd - 1);
+        std::string_view value = text.substr(keyEnd + 4, text.size() - keyEnd - 5);
+        values.emplace(std::string(key), std::string(value));
+        return true;
+    });
+}
+
+const std::unordered_map<std::string, std::string>& currentProperties() {
+    const char* root = sysio::replayRoot();
+    std::string_view key = root != nullptr ? root : "";
+    if (t_properties.root != key || t_properties.values.empty()) {
+        t_properties.root.assign(key);
+        t_properties.values.clear();
+        if (root != nullptr) {
+            // forEachLine 走 sysio，路径会被解析到回放目录下
+            parseProperties("/properties.txt", t_properties.values);
+        }
+    }
+    return t_properties.values;
+}
+
+} // namespace
+
+void setHostLogPriority(int priority) {
+    g_logPriority.store(priority, std::memory_order_relaxed);
+}
+
+extern "C" int __android_log_print(int prio, const char* tag, const char* fmt, ...) {
+    if (prio < g_logPriority.load(std::memory_order_relaxed)) {
+        return 0;
+    }
+    va_list args;
+    va_start(args, fmt);
+    fprintf(stderr, "[%s] ", tag);
+    int n = vfprintf(stderr, fmt, args);
+    fputc('\n', stderr);
+    va_end(args);
+    return n;
+}
+
+/**
+ * 与 bionic 一致：属性不存在时返回 0 并写入空串
+ */
+extern "C" int __system_property_get(const char* name, char* value) {
+    const auto& values = currentProperties();
+    auto it = values.find(name);
+    if (it == values.end()) {
+        value[0] = '\0';
+        return 0;
+    }
+    size_t len = std::min(it->second.size(), static_cast<size_t>(PROP_VALUE_MAX - 1));
+    memcpy(value, it->second.data(), len);
+    value[len] = '\0';
+    return static_cast<int>(len);
+}
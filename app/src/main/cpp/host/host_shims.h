@@ -0,0 +1,7 @@
+#pragma once
+
+/**
+ * 设置主机构建的日志输出级别（android_LogPriority），低于该级别的日志丢弃
+ * 默认 ANDROID_LOG_SILENT：批量回放时检测日志没有意义
+ */
+void setHostLogPriority(int priority);
@@ -0,0 +1,400 @@
+/**
+ * 离线规则评估工具（主机 CLI）
+ * 把 QA 采集的设备快照目录逐个重放给 native 检测，输出逐快照、逐规则的命中矩阵，
+ * 并按快照标注统计误报/漏报，用于规则改动上线前的评估
+ *
+ * 语料目录下每个子目录是一份快照，按设备上的绝对路径保存采集到的文件：
+ *   proc/self/{status,maps,smaps,mountinfo,cgroup,uid_map,gid_map,cmdline,environ}
+ *   proc/self/task/<tid>/comm、proc/self/fd/<n>（保留符号链接）、proc/self/map_files/、proc/self/ns/
+ *   proc/1/mountinfo、proc/cpuinfo、proc/net/{tcp,tcp6,unix}
+ *   su、frida、qemu 等探测路径（保留权限位）
+ *   properties.txt：getprop 的输出
+ *   labels：可选，空白分隔的预期类别（root hook debugger emulator virtual），干净设备写 clean
+ *
+ * 检测通过 sysio 访问文件，每个工作线程把自己当前的快照目录设为回放根目录（sysio::setReplayRoot），
+ * 检测代码与设备上完全相同；依赖进程自身内存、信号、计时、JNI 或实时进程状态
+ * （environ、getpid/getuid 等）的检测无法离线重放，不在规则表中
+ *
+ * 用法：rule_eval [-j 线程数] [-o matrix.csv] [-v] <语料目录>
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <dirent.h>
+#include <android/log.h>
+
+#include "host_shims.h"
+#include "proc_utils.h"
+#include "scan_context.h"
+#include "sys_io.h"
+
+// 外部声明可以离线重放的检测：输入全部来自文件和系统属性
+extern bool checkTracerPid();
+extern bool checkFridaPort();
+extern bool checkFridaThreads();
+extern bool checkFridaFiles();
+extern bool checkFridaInMemory();
+extern bool checkSuBinary();
+extern bool checkRootProperties();
+extern bool checkLoadedLibraries();
+extern bool checkEmulatorCpu();
+extern bool checkQemuFiles();
+extern bool checkSuspiciousStrings();
+extern bool checkMountNamespace();
+extern bool checkNamespaceFingerprint();
+extern bool checkMapsConsistency();
+extern bool checkFileDescriptors();
+
+namespace {
+
+/**
+ * 规则类别，也是快照标注的取值
+ */
+enum Category : uint8_t {
+    Root,
+    Hook,
+    Debugger,
+    Emulator,
+    Virtual,
+    CategoryCount
+};
+
+const char* const kCategoryNames[] = {"root", "hook", "debugger", "emulator", "virtual"};
+
+struct Rule {
+    const char* name;
+    Category category;
+    bool (*run)();
+};
+
+const Rule kRules[] = {
+        {"tracer_pid", Debugger, checkTracerPid},
+        {"frida_port", Hook, checkFridaPort},
+        {"frida_threads", Hook, checkFridaThreads},
+        {"frida_files", Hook, checkFridaFiles},
+        {"frida_in_memory", Hook, checkFridaInMemory},
+        {"loaded_libraries", Hook, checkLoadedLibraries},
+        {"suspicious_strings", Debugger, checkSuspiciousStrings},
+        {"maps_consistency", Hook, checkMapsConsistency},
+        {"file_descriptors", Hook, checkFileDescriptors},
+        {"su_binary", Root, checkSuBinary},
+        {"root_properties", Root, checkRootProperties},
+        {"mount_namespace", Root, checkMountNamespace},
+        {"emulator_cpu", Emulator, checkEmulatorCpu},
+        {"qemu_files", Emulator, checkQemuFiles},
+        {"namespace_fingerprint", Virtual, checkNamespaceFingerprint}
+};
+
+constexpr size_t kRuleCount = sizeof(kRules) / sizeof(kRules[0]);
+
+// 没有 labels 文件的快照只进入命中矩阵，不参与误报/漏报统计
+constexpr int kUnlabeled = -1;
+
+/**
+ * 单个快照的结果：标注的类别掩码和每条规则是否命中
+ */
+struct SnapshotResult {
+    int labels = kUnlabeled;
+    bool hits[kRuleCount] = {};
+};
+
+/**
+ * 工作窃取的任务区间
+ * 每个线程从自己区间的前端逐个取快照；取完后从其他线程剩余区间中切走后一半
+ * 单个快照的重放是几十次文件读取，区间上的互斥锁开销可以忽略
+ */
+struct WorkRange {
+    std::mutex mutex;
+    size_t begin = 0;
+    size_t end = 0;
+};
+
+class WorkPool {
+public:
+    WorkPool(size_t items, size_t workers) : ranges_(new WorkRange[workers]), workers_(workers) {
+        for (size_t i = 0; i < workers; i++) {
+            ranges_[i].begin = items * i / workers;
+            ranges_[i].end = items * (i + 1) / workers;
+        }
+    }
+
+    /**
+     * 取下一个任务，全部完成时返回 false
+     */
+    bool next(size_t worker, size_t& item) {
+        while (true) {
+            if (takeOwn(worker, item)) {
+                return true;
+            }
+            if (!steal(worker)) {
+                return false;
+            }
+        }
+    }
+
+private:
+    bool takeOwn(size_t worker, size_t& item) {
+        WorkRange& range = ranges_[worker];
+        std::lock_guard<std::mutex> lock(range.mutex);
+        if (range.begin == range.end) {
+            return false;
+        }
+        item = range.begin++;
+        return true;
+    }
+
+    bool steal(size_t worker) {
+        for (size_t offset = 1; offset < workers_; offset++) {
+            WorkRange& victim = ranges_[(worker + offset) % workers_];
+            size_t begin;
+            size_t end;
+            {
+                std::lock_guard<std::mutex> lock(victim.mutex);
+                size_t remaining = victim.end - victim.begin;
+                if (remaining == 0) continue;
+                end = victim.end;
+                begin = end - (remaining + 1) / 2;
+                victim.end = begin;
+            }
+            WorkRange& own = ranges_[worker];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            own.begin = begin;
+            own.end = end;
+            return true;
+        }
+        return false;
+    }
+
+    std::unique_ptr<WorkRange[]> ranges_;
+    size_t workers_;
+};
+
+/**
+ * 解析 labels 文件（路径经过回放根目录）
+ */
+int readLabels() {
+    std::string content;
+    if (!readFileFully("/labels", content)) {
+        return kUnlabeled;
+    }
+    int mask = 0;
+    size_t pos = 0;
+    while (pos < content.size()) {
+        size_t start = content.find_first_not_of(" \t\r\n,", pos);
+        if (start == std::string::npos) break;
+        size_t end = content.find_first_of(" \t\r\n,", start);
+        if (end == std::string::npos) end = content.size();
+        std::string token = content.substr(start, end - start);
+        for (int category = 0; category < CategoryCount; category++) {
+            if (token == kCategoryNames[category]) {
+                mask |= 1 << category;
+            }
+        }
+        pos = end;
+    }
+    return mask;
+}
+
+void replaySnapshot(const std::string& root, ScanContext& context, SnapshotResult& result) {
+    sysio::setReplayRoot(root.c_str());
+    context.reset();
+    result.labels = readLabels();
+    for (size_t rule = 0; rule < kRuleCount; rule++) {
+        result.hits[rule] = kRules[rule].run();
+    }
+    sysio::setReplayRoot(nullptr);
+}
+
+std::vector<std::string> listSnapshots(const std::string& corpus) {
+    std::vector<std::string> names;
+    forEachDirEntry(corpus.c_str(), [&](const sysio::Dirent64& entry) {
+        bool isDir = entry.d_type == DT_DIR;
+        if (entry.d_type == DT_UNKNOWN) {
+            struct stat st{};
+            isDir = pathExists((corpus + "/" + entry.d_name).c_str(), &st) && S_ISDIR(st.st_mode);
+        }
+        if (isDir) {
+            names.emplace_back(entry.d_name);
+        }
+        return true;
+    });
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+bool writeMatrix(const char* path, const std::vector<std::string>& names,
+                 const std::vector<SnapshotResult>& results) {
+    FILE* out = fopen(path, "w");
+    if (out == nullptr) {
+        return false;
+    }
+    fputs("snapshot,labels", out);
+    for (const Rule& rule : kRules) {
+        fprintf(out, ",%s", rule.name);
+    }
+    fputc('\n', out);
+
+    for (size_t i = 0; i < names.size(); i++) {
+        fprintf(out, "%s,", names[i].c_str());
+        if (results[i].labels == kUnlabeled) {
+            fputc('?', out);
+        } else if (results[i].labels == 0) {
+            fputs("clean", out);
+        } else {
+            const char* separator = "";
+            for (int category = 0; category < CategoryCount; category++) {
+                if (results[i].labels & (1 << category)) {
+                    fprintf(out, "%s%s", separator, kCategoryNames[category]);
+                    separator = " ";
+                }
+            }
+        }
+        for (bool hit : results[i].hits) {
+            fprintf(out, ",%d", hit ? 1 : 0);
+        }
+        fputc('\n', out);
+    }
+    return fclose(out) == 0;
+}
+
+double ratio(size_t numerator, size_t denominator) {
+    return denominator > 0 ? 100.0 * static_cast<double>(numerator) / static_cast<double>(denominator) : 0.0;
+}
+
+/**
+ * 逐规则：命中数、命中率，以及在有标注的快照上的误报（类别不在标注中却命中）和漏报（类别在标注中却未命中）
+ * 逐类别：同类任一规则命中即判为该类别，给出混淆矩阵、精确率和召回率
+ */
+void printSummary(const std::vector<SnapshotResult>& results) {
+    size_t total = results.size();
+    size_t labeled = 0;
+    for (const SnapshotResult& result : results) {
+        if (result.labels != kUnlabeled) labeled++;
+    }
+
+    printf("\n%-24s %-9s %8s %8s %8s %8s\n", "rule", "category", "hits", "hit%", "FP", "FN");
+    for (size_t rule = 0; rule < kRuleCount; rule++) {
+        int bit = 1 << kRules[rule].category;
+        size_t hits = 0;
+        size_t falsePositives = 0;
+        size_t falseNegatives = 0;
+        for (const SnapshotResult& result : results) {
+            bool hit = result.hits[rule];
+            if (hit) hits++;
+            if (result.labels == kUnlabeled) continue;
+            bool expected = (result.labels & bit) != 0;
+            if (hit && !expected) falsePositives++;
+            if (!hit && expected) falseNegatives++;
+        }
+        printf("%-24s %-9s %8zu %7.2f%% %8zu %8zu\n", kRules[rule].name,
+               kCategoryNames[kRules[rule].category], hits, ratio(hits, total), falsePositives, falseNegatives);
+    }
+
+    if (labeled == 0) {
+        printf("\nNo labeled snapshots, skipping per-category confusion matrix\n");
+        return;
+    }
+
+    printf("\n%-9s %8s %8s %8s %8s %10s %8s\n", "category", "TP", "FP", "FN", "TN", "precision", "recall");
+    for (int category = 0; category < CategoryCount; category++) {
+        size_t tp = 0, fp = 0, fn = 0, tn = 0;
+        for (const SnapshotResult& result : results) {
+            if (result.labels == kUnlabeled) continue;
+            bool detected = false;
+            for (size_t rule = 0; rule < kRuleCount; rule++) {
+                detected |= kRules[rule].category == category && result.hits[rule];
+            }
+            bool expected = (result.labels & (1 << category)) != 0;
+            if (detected && expected) tp++;
+            else if (detected) fp++;
+            else if (expected) fn++;
+            else tn++;
+        }
+        printf("%-9s %8zu %8zu %8zu %8zu %9.2f%% %7.2f%%\n", kCategoryNames[category],
+               tp, fp, fn, tn, ratio(tp, tp + fp), ratio(tp, tp + fn));
+    }
+}
+
+void usage(const char* program) {
+    fprintf(stderr, "usage: %s [-j threads] [-o matrix.csv] [-v] <corpus-dir>\n", program);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t workers = std::max(1u, std::thread::hardware_concurrency());
+    const char* matrixPath = nullptr;
+    const char* corpusArg = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            workers = static_cast<size_t>(std::max(1, atoi(argv[++i])));
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            matrixPath = argv[++i];
+        } else if (strcmp(argv[i], "-v") == 0) {
+            setHostLogPriority(ANDROID_LOG_WARN);
+        } else if (argv[i][0] != '-' && corpusArg == nullptr) {
+            corpusArg = argv[i];
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (corpusArg == nullptr) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    std::string corpus(corpusArg);
+    while (corpus.size() > 1 && corpus.back() == '/') {
+        corpus.pop_back();
+    }
+    std::vector<std::string> names = listSnapshots(corpus);
+    if (names.empty()) {
+        fprintf(stderr, "No snapshots found in %s\n", corpus.c_str());
+        return 1;
+    }
+    workers = std::min(workers, names.size());
+
+    std::vector<SnapshotResult> results(names.size());
+    WorkPool pool(names.size(), workers);
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    for (size_t worker = 0; worker < workers; worker++) {
+        threads.emplace_back([&, worker] {
+            ScanContext context;
+            ScanContextScope scope(context);
+            std::string root;
+            size_t item;
+            while (pool.next(worker, item)) {
+                root = corpus + "/" + names[item];
+                replaySnapshot(root, context, results[item]);
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("Replayed %zu snapshots x %zu rules on %zu threads in %.2fs (%.0f snapshots/min)\n",
+           names.size(), kRuleCount, workers, seconds, names.size() / std::max(seconds, 1e-9) * 60.0);
+
+    printSummary(results);
+
+    if (matrixPath != nullptr && !writeMatrix(matrixPath, names, results)) {
+        fprintf(stderr, "Failed to write %s\n", matrixPath);
+        return 1;
+    }
+    return 0;
+}
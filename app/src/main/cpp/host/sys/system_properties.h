@@ -0,0 +1,18 @@
+#pragma once
+
+/**
+ * 主机构建用的 sys/system_properties.h 替身
+ * 属性从当前线程回放目录下的 properties.txt（getprop 输出格式）读取，见 host_shims.cpp
+ */
+
+#define PROP_VALUE_MAX 92
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int __system_property_get(const char* name, char* value);
+
+#ifdef __cplusplus
+}
+#endif
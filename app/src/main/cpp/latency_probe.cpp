@@ -0,0 +1,199 @@
+#include <jni.h>
+#include <algorithm>
+#include <string>
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <android/log.h>
+
+#include "event_log.h"
+#include "module_index.h"
+#include "proc_snapshot.h"
+#include "sys_io.h"
+#include "timing_probe.h"
+
+#define LOG_TAG "LatencyProbe"
+#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN, LOG_TAG, __VA_ARGS__)
+
+namespace {
+
+// 每对函数最多采集的样本数，每个样本连续调用 kBatch 次
+constexpr int kMaxSamples = 256;
+constexpr int kBatch = 4;
+
+// 样本太少时统计量不可信，不做判断
+constexpr int kMinSamples = 32;
+
+// 所有测量共享的总时限
+constexpr int64_t kTotalBudgetNs = 4 * 1000 * 1000;
+
+// 开销需要超过基线噪声（MAD）的倍数
+constexpr double kMadFactor = 8.0;
+
+/**
+ * 中位数与中位数绝对偏差（MAD），对偶发的调度抖动不敏感
+ */
+struct RobustStats {
+    double median;
+    double mad;
+};
+
+RobustStats robustStats(int64_t* samples, int count) {
+    int64_t scratch[kMaxSamples];
+    std::nth_element(samples, samples + count / 2, samples + count);
+    int64_t median = samples[count / 2];
+    for (int i = 0; i < count; i++) {
+        scratch[i] = samples[i] > median ? samples[i] - median : median - samples[i];
+    }
+    std::nth_element(scratch, scratch + count / 2, scratch + count);
+    return {static_cast<double>(median) / kBatch, static_cast<double>(scratch[count / 2]) / kBatch};
+}
+
+/**
+ * 交替测量被测函数与基线，两者经历同样的调频和调度环境
+ * 计时循环内只有栈上数组写入，没有任何分配
+ */
+template <typename Subject, typename Baseline>
+bool measurePair(const char* name, double minOverheadNs, int64_t budgetNs,
+                 Subject&& subject, Baseline&& baseline) {
+    int64_t subjectSamples[kMaxSamples];
+    int64_t baselineSamples[kMaxSamples];
+
+    int count = 0;
+    int64_t deadline = monotonicNowNs() + budgetNs;
+    while (count < kMaxSamples && monotonicNowNs() < deadline) {
+        int64_t t0 = monotonicNowNs();
+        for (int i = 0; i < kBatch; i++) baseline();
+        int64_t t1 = monotonicNowNs();
+        for (int i = 0; i < kBatch; i++) subject();
+        int64_t t2 = monotonicNowNs();
+
+        baselineSamples[count] = t1 - t0;
+        subjectSamples[count] = t2 - t1;
+        count++;
+    }
+    if (count < kMinSamples) {
+        LOGD("%s: only %d samples within budget, skipped", name, count);
+        return false;
+    }
+
+    RobustStats subjectStats = robustStats(subjectSamples, count);
+    RobustStats baselineStats = robustStats(baselineSamples, count);
+    double overhead = subjectStats.median - baselineStats.median;
+    double noise = std::max(subjectStats.mad, baselineStats.mad);
+
+    LOGD("%s: %.0f ns vs baseline %.0f ns (MAD %.0f), %d samples",
+         name, subjectStats.median, baselineStats.median, noise, count);
+    if (overhead > minOverheadNs && overhead > kMadFactor * noise) {
+        LOGW("Instrumentation overhead on %s: +%.0f ns per call", name, overhead);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * JNIEnv 函数表中的入口必须位于 libart 内，被替换的表项直接可见
+ */
+bool isJniTableReplaced(JNIEnv* env) {
+    const void* const entries[] = {
+            reinterpret_cast<const void*>(env->functions->GetStringUTFChars),
+            reinterpret_cast<const void*>(env->functions->CallObjectMethod),
+            reinterpret_cast<const void*>(env->functions->FindClass),
+            reinterpret_cast<const void*>(env->functions->RegisterNatives)
+    };
+
+    ModuleIndex index(currentSnapshot().maps());
+    bool replaced = false;
+    for (const void* entry : entries) {
+        auto addr = reinterpret_cast<uintptr_t>(entry);
+        CodeOrigin origin = index.classify(addr);
+        if (origin != CodeOrigin::Runtime) {
+            EVLOG_W(ForeignJniFunction, addr, eventlog::intern(index.pathOf(addr)),
+                    eventlog::intern(ModuleIndex::originName(origin)));
+            replaced = true;
+        }
+    }
+    return replaced;
+}
+
+} // namespace
+
+/**
+ * 检测 Hook：热点 libc 与 JNI 函数的调用延迟指纹
+ * Hook 会给每次调用带来可测量的额外开销。libc 的 getppid/read/openat 与同一系统调用的
+ * 内联 svc 版本交替计时；JNI 的 GetStringUTFChars、CallObjectMethod 与功能相近、
+ * 很少被 Hook 的 GetStringUTFLength、CallNonvirtualObjectMethod 比较。
+ * 用中位数和 MAD 比较，整轮测量限制在 4ms 内
+ */
+bool checkCallLatency(JNIEnv* env) {
+    if (isJniTableReplaced(env)) {
+        return true;
+    }
+
+    int devZero = sysio::openat(AT_FDCWD, "/dev/zero", O_RDONLY | O_CLOEXEC);
+    jstring probe = env->NewStringUTF("environment-detector-latency-probe");
+    jclass objectClass = env->FindClass("java/lang/Object");
+    jmethodID getClass = objectClass != nullptr
+                         ? env->GetMethodID(objectClass, "getClass", "()Ljava/lang/Class;") : nullptr;
+    if (devZero < 0 || probe == nullptr || getClass == nullptr) {
+        if (env->ExceptionCheck()) env->ExceptionClear();
+        if (devZero >= 0) sysio::close(devZero);
+        return false;
+    }
+
+    const int64_t pairBudget = kTotalBudgetNs / 5;
+    char byte = 0;
+    int hooked = 0;
+
+    // bionic 的 getpid() 读的是缓存的 pid，不进内核；getppid() 每次都是真正的系统调用
+    if (measurePair("getppid", 150, pairBudget,
+                    [] { getppid(); },
+                    [] { sysio::directSyscall(__NR_getppid); })) hooked++;
+
+    if (measurePair("read", 150, pairBudget,
+                    [devZero, &byte] { read(devZero, &byte, 1); },
+                    [devZero, &byte] { sysio::directSyscall(__NR_read, devZero, reinterpret_cast<long>(&byte), 1); }))
+        hooked++;
+
+    if (measurePair("openat", 150, pairBudget,
+                    [] { close(openat(AT_FDCWD, "/dev/null", O_RDONLY | O_CLOEXEC)); },
+                    [] {
+                        long fd = sysio::directSyscall(__NR_openat, AT_FDCWD,
+                                                       reinterpret_cast<long>("/dev/null"), O_RDONLY | O_CLOEXEC);
+                        sysio::directSyscall(__NR_close, fd);
+                    })) hooked++;
+
+    // JNI 调用本身较重且 CheckJNI 会放大差异，门槛取微秒级，只捕获明显的 Hook 开销
+    if (measurePair("GetStringUTFChars", 1000, pairBudget,
+                    [env, probe] {
+                        const char* chars = env->GetStringUTFChars(probe, nullptr);
+                        if (chars != nullptr) env->ReleaseStringUTFChars(probe, chars);
+                    },
+                    [env, probe] { env->GetStringUTFLength(probe); })) hooked++;
+
+    if (measurePair("CallObjectMethod", 1000, pairBudget,
+                    [env, probe, getClass] { env->DeleteLocalRef(env->CallObjectMethod(probe, getClass)); },
+                    [env, probe, objectClass, getClass] {
+                        env->DeleteLocalRef(env->CallNonvirtualObjectMethod(probe, objectClass, getClass));
+                    })) hooked++;
+
+    sysio::close(devZero);
+    env->DeleteLocalRef(probe);
+    env->DeleteLocalRef(objectClass);
+    return hooked > 0;
+}
+
+extern "C"
+JNIEXPORT jboolean JNICALL
+Java_com_grtsinry43_environmentdetector_security_NativeSecurityDetector_nativeCheckCallLatency(
+        JNIEnv* env,
+        jclass clazz) {
+
+    EVLOG_D(CheckStarted, CheckId::CallLatency);
+
+    bool hooked = checkCallLatency(env);
+
+    EVLOG_I(CheckResult, CheckId::CallLatency, hooked);
+    return hooked;
+}
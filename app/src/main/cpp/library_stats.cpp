@@ -0,0 +1,89 @@
+#include <jni.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <android/log.h>
+
+#include "proc_utils.h"
+
+#define LOG_TAG "LibraryStats"
+#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+
+namespace {
+
+bool endsWith(const char* text, size_t len, const std::string& suffix) {
+    return len >= suffix.size() && memcmp(text + len - suffix.size(), suffix.data(), suffix.size()) == 0;
+}
+
+/**
+ * smaps 中映射头部行以十六进制地址开头，其余为 "Key:   value kB" 形式的统计行
+ */
+bool isMappingHeader(const char* line, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        char c = line[i];
+        if (c == '-') return i > 0;
+        bool hex = (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f');
+        if (!hex) return false;
+    }
+    return false;
+}
+
+} // namespace
+
+/**
+ * 统计一组 native 库各自所有映射的常驻内存（KB），用于衡量引导库和各扫描模块的内存开销
+ * 库名不带 lib 前缀和 .so 后缀，一次遍历 smaps 得到全部结果；
+ * 库未加载时对应项为 0，smaps 不可读时全部为 -1
+ */
+extern "C"
+JNIEXPORT jlongArray JNICALL
+Java_com_grtsinry43_environmentdetector_security_NativeSecurityDetector_nativeGetLibraryRss(
+        JNIEnv* env,
+        jclass clazz,
+        jobjectArray libraryNames) {
+
+    jsize count = env->GetArrayLength(libraryNames);
+    std::vector<std::string> suffixes;
+    suffixes.reserve(static_cast<size_t>(count));
+    for (jsize i = 0; i < count; i++) {
+        auto name = static_cast<jstring>(env->GetObjectArrayElement(libraryNames, i));
+        const char* nameChars = name != nullptr ? env->GetStringUTFChars(name, nullptr) : nullptr;
+        suffixes.push_back(nameChars != nullptr ? std::string("/lib") + nameChars + ".so" : std::string());
+        if (nameChars != nullptr) env->ReleaseStringUTFChars(name, nameChars);
+        if (name != nullptr) env->DeleteLocalRef(name);
+    }
+
+    std::vector<jlong> rssKb(static_cast<size_t>(count), 0);
+    long current = -1;
+    bool ok = forEachLine("/proc/self/smaps", [&](const char* line, size_t len) {
+        if (isMappingHeader(line, len)) {
+            while (len > 0 && line[len - 1] == ' ') len--;
+            current = -1;
+            for (size_t i = 0; i < suffixes.size(); i++) {
+                if (!suffixes[i].empty() && endsWith(line, len, suffixes[i])) {
+                    current = static_cast<long>(i);
+                    break;
+                }
+            }
+        } else if (current >= 0 && len > 4 && memcmp(line, "Rss:", 4) == 0) {
+            rssKb[static_cast<size_t>(current)] += strtol(line + 4, nullptr, 10);
+        }
+        return true;
+    });
+    if (!ok) {
+        std::fill(rssKb.begin(), rssKb.end(), -1);
+    }
+
+    for (size_t i = 0; i < suffixes.size(); i++) {
+        LOGD("RSS of %s: %lld kB", suffixes[i].c_str() + (suffixes[i].empty() ? 0 : 1),
+             static_cast<long long>(rssKb[i]));
+    }
+
+    jlongArray result = env->NewLongArray(count);
+    if (result != nullptr) {
+        env->SetLongArrayRegion(result, 0, count, rssKb.data());
+    }
+    return result;
+}
@@ -0,0 +1,165 @@
+#include <jni.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <unistd.h>
+#include <android/log.h>
+
+#include "event_log.h"
+#include "proc_snapshot.h"
+#include "proc_utils.h"
+
+#define LOG_TAG "ProcessLineage"
+#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN, LOG_TAG, __VA_ARGS__)
+
+namespace {
+
+/**
+ * 父进程的判定结果
+ */
+enum class Lineage {
+    Unknown,    // 父进程信息不可读（hidepid 或权限不足）
+    Zygote,     // zygote 家族孵化，正常
+    Foreign     // 由其它进程启动
+};
+
+/**
+ * 合法的父进程名：zygote/zygote64、USAP 池、WebView zygote 以及应用 zygote（<包名>_zygote）
+ */
+const char* const kZygoteNames[] = {
+        "zygote",
+        "zygote64",
+        "usap32",
+        "usap64",
+        "webview_zygote"
+};
+
+constexpr const char* kAppZygoteSuffix = "_zygote";
+constexpr const char* kAppProcessPrefix = "/system/bin/app_process";
+
+const char* const kInstrumentationNames[] = {
+        "frida",
+        "gdbserver",
+        "gdb",
+        "lldb-server",
+        "strace",
+        "ltrace"
+};
+
+/**
+ * 按进程缓存：pid 或 PPid 变化（fork 出的子进程、被重新托管）时才重新判定
+ */
+struct LineageCache {
+    pid_t pid = 0;
+    pid_t ppid = 0;
+    Lineage result = Lineage::Unknown;
+};
+
+std::mutex g_lineageMutex;
+LineageCache g_lineageCache;
+
+bool isZygoteName(const std::string& name) {
+    for (const char* zygote : kZygoteNames) {
+        if (name == zygote) return true;
+    }
+    size_t suffixLen = strlen(kAppZygoteSuffix);
+    return name.size() > suffixLen &&
+           name.compare(name.size() - suffixLen, suffixLen, kAppZygoteSuffix) == 0;
+}
+
+bool hasInstrumentationName(const std::string& name) {
+    for (const char* tool : kInstrumentationNames) {
+        if (name.find(tool) != std::string::npos) return true;
+    }
+    return false;
+}
+
+/**
+ * 读取父进程的 cmdline（只取第一个参数）和 comm，再尽力读取 exe 链接
+ */
+Lineage inspectParent(pid_t ppid) {
+    char path[64];
+    std::string cmdline;
+    std::string comm;
+
+    snprintf(path, sizeof(path), "/proc/%d/cmdline", ppid);
+    bool cmdlineOk = readFileFully(path, cmdline);
+    snprintf(path, sizeof(path), "/proc/%d/comm", ppid);
+    bool commOk = readFileFully(path, comm);
+    if (!cmdlineOk && !commOk) {
+        return Lineage::Unknown;
+    }
+
+    cmdline.resize(strlen(cmdline.c_str()));
+    while (!comm.empty() && comm.back() == '\n') comm.pop_back();
+
+    if (hasInstrumentationName(cmdline) || hasInstrumentationName(comm)) {
+        LOGW("Spawned by instrumentation tool: %s (%s)", cmdline.c_str(), comm.c_str());
+        return Lineage::Foreign;
+    }
+
+    // zygote 以 root 运行，exe 链接通常不可读；能读到时必须是 app_process
+    std::string exe;
+    snprintf(path, sizeof(path), "/proc/%d/exe", ppid);
+    if (readLinkString(path, exe) && exe.compare(0, strlen(kAppProcessPrefix), kAppProcessPrefix) != 0) {
+        LOGW("Parent executable is not app_process: %s", exe.c_str());
+        return Lineage::Foreign;
+    }
+
+    // comm 最长 15 个字符，应用 zygote 的名字可能被截断，以 cmdline 为准
+    const std::string& name = cmdlineOk && !cmdline.empty() ? cmdline : comm;
+    if (!isZygoteName(name)) {
+        LOGW("Unexpected parent process: %s (%s)", cmdline.c_str(), comm.c_str());
+        return Lineage::Foreign;
+    }
+    return Lineage::Zygote;
+}
+
+} // namespace
+
+/**
+ * 检测调试/注入：进程血缘
+ * 正常的应用进程一定由 zygote 家族孵化；frida-server spawn、gdbserver 启动
+ * 或 app_process 包装器启动的进程，父进程会是这些工具本身
+ * 只有一次 status 读取（来自快照）加两次小文件读取，结果按进程缓存；
+ * /proc 开启 hidepid 时父进程不可见，此时不做判断
+ */
+bool checkProcessLineage() {
+    std::string value;
+    if (!findStatusField(currentSnapshot().get(ProcFile::Status), "PPid", value)) {
+        return false;
+    }
+    pid_t ppid = static_cast<pid_t>(atoi(value.c_str()));
+    pid_t pid = getpid();
+
+    Lineage result;
+    {
+        std::lock_guard<std::mutex> lock(g_lineageMutex);
+        if (g_lineageCache.pid != pid || g_lineageCache.ppid != ppid) {
+            g_lineageCache.pid = pid;
+            g_lineageCache.ppid = ppid;
+            g_lineageCache.result = ppid > 0 ? inspectParent(ppid) : Lineage::Unknown;
+        }
+        result = g_lineageCache.result;
+    }
+
+    LOGD("Parent %d lineage: %d", ppid, static_cast<int>(result));
+    return result == Lineage::Foreign;
+}
+
+extern "C"
+JNIEXPORT jboolean JNICALL
+Java_com_grtsinry43_environmentdetector_security_NativeSecurityDetector_nativeCheckProcessLineage(
+        JNIEnv* env,
+        jclass clazz) {
+
+    EVLOG_D(CheckStarted, CheckId::ProcessLineage);
+
+    bool foreign = checkProcessLineage();
+
+    EVLOG_I(CheckResult, CheckId::ProcessLineage, foreign);
+    return foreign;
+}
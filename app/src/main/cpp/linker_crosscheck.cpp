@@ -0,0 +1,172 @@
+#include <jni.h>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <link.h>
+#include <unistd.h>
+#include <android/log.h>
+
+#include "event_log.h"
+#include "proc_snapshot.h"
+#include "proc_utils.h"
+
+#define LOG_TAG "LinkerCrossCheck"
+#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+
+namespace {
+
+/**
+ * 链接器已知的一段可执行区间
+ */
+struct LinkerRange {
+    uintptr_t start;
+    uintptr_t end;
+    const char* name;
+};
+
+// 由 ART 自己映射的文件，链接器不一定知道它们
+const char* const kArtManagedSuffixes[] = {
+        ".oat",
+        ".odex",
+        ".art",
+        ".vdex",
+        ".dex",
+        ".jar"
+};
+
+bool isArtManaged(std::string_view path) {
+    for (const char* suffix : kArtManagedSuffixes) {
+        size_t len = strlen(suffix);
+        if (path.size() >= len && path.compare(path.size() - len, len, suffix) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * 只关心真正来自文件系统的可执行映射
+ * 匿名、[vdso]、ashmem/memfd（JIT 缓存）都不经过链接器
+ */
+bool isLinkerCandidate(const MapEntry& entry, const std::string& path) {
+    if ((entry.perms & kMapExec) == 0 || entry.pathId == 0) return false;
+    if (path[0] != '/') return false;
+    if (path.compare(0, 5, "/dev/") == 0 || path.compare(0, 7, "/memfd:") == 0) return false;
+    return !isArtManaged(path);
+}
+
+int collectLinkerRange(struct dl_phdr_info* info, size_t /*size*/, void* data) {
+    auto* ranges = static_cast<std::vector<LinkerRange>*>(data);
+    uintptr_t pageMask = static_cast<uintptr_t>(getpagesize()) - 1;
+
+    for (int i = 0; i < info->dlpi_phnum; i++) {
+        const ElfW(Phdr)& phdr = info->dlpi_phdr[i];
+        if (phdr.p_type != PT_LOAD || (phdr.p_flags & PF_X) == 0) continue;
+
+        uintptr_t start = (info->dlpi_addr + phdr.p_vaddr) & ~pageMask;
+        uintptr_t end = (info->dlpi_addr + phdr.p_vaddr + phdr.p_memsz + pageMask) & ~pageMask;
+        ranges->push_back({start, end, info->dlpi_name});
+    }
+    return 0;
+}
+
+/**
+ * 线性归并：maps 中的可执行文件映射必须落在某个链接器区间内
+ */
+int countUnlinkedMappings(const MapsSnapshot& maps, const std::vector<LinkerRange>& linker) {
+    int unlinked = 0;
+    size_t j = 0;
+    for (const MapEntry& entry : maps.entries()) {
+        const std::string& path = maps.pathOf(entry);
+        if (!isLinkerCandidate(entry, path)) continue;
+
+        while (j < linker.size() && linker[j].end <= entry.start) j++;
+
+        bool covered = j < linker.size() &&
+                       linker[j].start <= entry.start && entry.end <= linker[j].end;
+        if (!covered) {
+            unlinked++;
+            EVLOG_W(UnlinkedExecMapping, eventlog::intern(path), entry.start);
+        }
+    }
+    return unlinked;
+}
+
+/**
+ * 反向检查：链接器声称加载的代码必须真的存在于 maps 中
+ * 伪造的 soinfo 或者被 maps 过滤隐藏的库会在这里暴露
+ */
+int countPhantomObjects(const MapsSnapshot& maps, const std::vector<LinkerRange>& linker) {
+    const std::vector<MapEntry>& entries = maps.entries();
+    int phantom = 0;
+    size_t i = 0;
+    for (const LinkerRange& range : linker) {
+        while (i < entries.size() && entries[i].end <= range.start) i++;
+
+        // 区间可能被拆成多段 vma，逐段确认连续覆盖
+        uintptr_t cursor = range.start;
+        size_t k = i;
+        while (k < entries.size() && entries[k].start <= cursor && cursor < range.end) {
+            cursor = entries[k].end;
+            k++;
+        }
+        if (cursor < range.end) {
+            phantom++;
+            EVLOG_W(PhantomLinkerObject, eventlog::intern(range.name != nullptr ? range.name : "?"), range.start);
+        }
+    }
+    return phantom;
+}
+
+} // namespace
+
+/**
+ * 检测 Hook：链接器视图与 maps 视图交叉比对
+ * Riru/Zygisk 模块加载后会把自己从 soinfo 链表中摘除，但代码仍然映射在内存里
+ */
+bool checkLinkerConsistency() {
+    const MapsSnapshot& maps = currentSnapshot().maps();
+    if (maps.entries().empty()) {
+        return false;
+    }
+
+    std::vector<LinkerRange> linker;
+    linker.reserve(512);
+    dl_iterate_phdr(collectLinkerRange, &linker);
+    std::sort(linker.begin(), linker.end(),
+              [](const LinkerRange& a, const LinkerRange& b) { return a.start < b.start; });
+
+    int unlinked = countUnlinkedMappings(maps, linker);
+    int phantom = countPhantomObjects(maps, linker);
+
+    // 快照可能早于最近的 dlopen/dlclose，有差异时用新读取的 maps 再确认一次
+    if (unlinked > 0 || phantom > 0) {
+        std::string content;
+        if (readFileFully("/proc/self/maps", content)) {
+            MapsSnapshot fresh;
+            fresh.parse(content);
+            unlinked = countUnlinkedMappings(fresh, linker);
+            phantom = countPhantomObjects(fresh, linker);
+        }
+    }
+
+    LOGD("Linker objects: %zu ranges, unlinked mappings: %d, phantom objects: %d",
+         linker.size(), unlinked, phantom);
+    return unlinked > 0 || phantom > 0;
+}
+
+extern "C"
+JNIEXPORT jboolean JNICALL
+Java_com_grtsinry43_environmentdetector_security_NativeSecurityDetector_nativeCheckLinkerConsistency(
+        JNIEnv* env,
+        jclass clazz) {
+
+    EVLOG_D(CheckStarted, CheckId::LinkerConsistency);
+
+    bool inconsistent = checkLinkerConsistency();
+
+    EVLOG_I(CheckResult, CheckId::LinkerConsistency, inconsistent);
+    return inconsistent;
+}
@@ -0,0 +1,170 @@
+#include <jni.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "event_log.h"
+#include "proc_snapshot.h"
+#include "proc_utils.h"
+
+namespace {
+
+struct Range {
+    uintptr_t start;
+    uintptr_t end;
+
+    bool operator<(const Range& other) const {
+        return start != other.start ? start < other.start : end < other.end;
+    }
+    bool operator==(const Range& other) const {
+        return start == other.start && end == other.end;
+    }
+};
+
+/**
+ * 解析 map_files 目录项名 "start-end"
+ */
+bool parseRangeName(const char* name, Range& range) {
+    char* end = nullptr;
+    range.start = static_cast<uintptr_t>(strtoull(name, &end, 16));
+    if (end == name || *end != '-') return false;
+    const char* endStart = end + 1;
+    range.end = static_cast<uintptr_t>(strtoull(endStart, &end, 16));
+    return end != endStart && *end == '\0';
+}
+
+/**
+ * 用 getdents64 枚举 /proc/self/map_files
+ * 每个文件映射一个目录项，内容来自内核的 vma 链表而不是 maps 的文本输出
+ */
+bool collectMapFiles(std::vector<Range>& ranges) {
+    ranges.clear();
+    bool ok = forEachDirEntry("/proc/self/map_files", [&ranges](const sysio::Dirent64& entry) {
+        Range range{};
+        if (parseRangeName(entry.d_name, range)) {
+            ranges.push_back(range);
+        }
+        return true;
+    });
+
+    std::sort(ranges.begin(), ranges.end());
+    return ok && !ranges.empty();
+}
+
+/**
+ * 只比较关联了文件的映射（包括 memfd/ashmem）
+ * 只有它们会出现在 map_files 中；匿名映射会随着分配器扩张在两次读取之间被拆分合并，
+ * 比较它们只会产生竞争噪声，而按路径过滤的隐藏手段针对的正是文件映射
+ * anon_inode:（dmabuf、GPU 驱动等）虽然也在 map_files 中，但不是真正的文件，
+ * 单独收集到 anonInodes，由调用方从 map_files 一侧排除，保证两边按同一规则过滤
+ */
+void collectFileRanges(const MapsSnapshot& maps, std::vector<Range>& ranges, std::vector<Range>& anonInodes) {
+    ranges.clear();
+    ranges.reserve(maps.entries().size());
+    for (const MapEntry& entry : maps.entries()) {
+        const std::string& path = maps.pathOf(entry);
+        if (path.compare(0, 11, "anon_inode:") == 0) {
+            anonInodes.push_back({entry.start, entry.end});
+            continue;
+        }
+        if (entry.inode == 0 || path[0] != '/') continue;
+        ranges.push_back({entry.start, entry.end});
+    }
+}
+
+/**
+ * 有序对称差：在一个视图中存在而另一个视图中缺失的区间
+ */
+void appendMismatches(const std::vector<Range>& a, const std::vector<Range>& b,
+                      std::vector<Range>& mismatches) {
+    std::set_symmetric_difference(a.begin(), a.end(), b.begin(), b.end(),
+                                  std::back_inserter(mismatches));
+}
+
+/**
+ * 对三个视图做一轮比较，返回所有不一致的区间（有序去重）
+ */
+void compareViews(const std::string& mapsContent, const std::string& smapsContent,
+                  std::vector<Range>& mismatches) {
+    mismatches.clear();
+
+    MapsSnapshot maps;
+    maps.parse(mapsContent);
+    MapsSnapshot smaps;
+    smaps.parseSmapsHeaders(smapsContent);
+
+    std::vector<Range> mapsRanges;
+    std::vector<Range> smapsRanges;
+    std::vector<Range> anonInodes;
+    collectFileRanges(maps, mapsRanges, anonInodes);
+    collectFileRanges(smaps, smapsRanges, anonInodes);
+    appendMismatches(mapsRanges, smapsRanges, mismatches);
+
+    std::vector<Range> mapFiles;
+    if (collectMapFiles(mapFiles)) {
+        std::sort(anonInodes.begin(), anonInodes.end());
+        mapFiles.erase(std::remove_if(mapFiles.begin(), mapFiles.end(), [&anonInodes](const Range& range) {
+            return std::binary_search(anonInodes.begin(), anonInodes.end(), range);
+        }), mapFiles.end());
+        appendMismatches(mapsRanges, mapFiles, mismatches);
+    }
+
+    std::sort(mismatches.begin(), mismatches.end());
+    mismatches.erase(std::unique(mismatches.begin(), mismatches.end()), mismatches.end());
+}
+
+} // namespace
+
+/**
+ * 检测 Hook：maps、smaps、map_files 多视图一致性
+ * 被 Hook 的 read/fgets 可以清洗 maps 的文本，但很难同时伪造三个视图；
+ * 三个视图由不同的读取时刻生成，只有连续两轮都不一致的区间才上报，排除正常的 mmap 竞争
+ */
+bool checkMapsConsistency() {
+    ProcSnapshot& snapshot = currentSnapshot();
+    if (!snapshot.available(ProcFile::Maps) || !snapshot.available(ProcFile::Smaps)) {
+        return false;
+    }
+
+    std::vector<Range> first;
+    compareViews(snapshot.get(ProcFile::Maps), snapshot.get(ProcFile::Smaps), first);
+    if (first.empty()) {
+        return false;
+    }
+
+    std::string mapsContent;
+    std::string smapsContent;
+    if (!readFileFully("/proc/self/maps", mapsContent) ||
+        !readFileFully("/proc/self/smaps", smapsContent)) {
+        return false;
+    }
+
+    std::vector<Range> second;
+    compareViews(mapsContent, smapsContent, second);
+
+    std::vector<Range> stable;
+    std::set_intersection(first.begin(), first.end(), second.begin(), second.end(),
+                          std::back_inserter(stable));
+
+    for (const Range& range : stable) {
+        EVLOG_W(MapsViewMismatch, range.start, range.end);
+    }
+    return !stable.empty();
+}
+
+extern "C"
+JNIEXPORT jboolean JNICALL
+Java_com_grtsinry43_environmentdetector_security_NativeSecurityDetector_nativeCheckMapsConsistency(
+        JNIEnv* env,
+        jclass clazz) {
+
+    EVLOG_D(CheckStarted, CheckId::MapsConsistency);
+
+    bool inconsistent = checkMapsConsistency();
+
+    EVLOG_I(CheckResult, CheckId::MapsConsistency, inconsistent);
+    return inconsistent;
+}
@@ -0,0 +1,97 @@
+#include "module_index.h"
+
+#include <string_view>
+
+namespace {
+
+constexpr uint8_t kUnclassified = 0xFF;
+
+bool startsWith(std::string_view str, std::string_view prefix) {
+    return str.size() >= prefix.size() && str.compare(0, prefix.size(), prefix) == 0;
+}
+
+bool endsWith(std::string_view str, std::string_view suffix) {
+    return str.size() >= suffix.size() &&
+           str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+bool contains(std::string_view str, std::string_view needle) {
+    return str.find(needle) != std::string_view::npos;
+}
+
+// 只读分区，普通应用无法在这里放置文件
+const char* const kSystemPrefixes[] = {
+        "/system/",
+        "/apex/",
+        "/vendor/",
+        "/product/",
+        "/system_ext/",
+        "/odm/"
+};
+
+} // namespace
+
+ModuleIndex::ModuleIndex(const MapsSnapshot& maps)
+        : maps_(maps), origins_(maps.paths().size(), kUnclassified) {}
+
+CodeOrigin ModuleIndex::classify(uintptr_t addr) const {
+    const MapEntry* entry = maps_.find(addr);
+    if (entry == nullptr) {
+        return CodeOrigin::Unmapped;
+    }
+    uint8_t& cached = origins_[entry->pathId];
+    if (cached == kUnclassified) {
+        cached = static_cast<uint8_t>(classifyPath(entry->pathId));
+    }
+    return static_cast<CodeOrigin>(cached);
+}
+
+const std::string& ModuleIndex::pathOf(uintptr_t addr) const {
+    const MapEntry* entry = maps_.find(addr);
+    return maps_.paths().path(entry != nullptr ? entry->pathId : 0);
+}
+
+CodeOrigin ModuleIndex::classifyPath(uint32_t pathId) const {
+    std::string_view path = maps_.paths().path(pathId);
+    if (path.empty()) {
+        return CodeOrigin::Anonymous;
+    }
+
+    if (contains(path, "jit-cache") || contains(path, "jit-code-cache") ||
+        contains(path, "jit-zygote-cache")) {
+        return CodeOrigin::Jit;
+    }
+    if (endsWith(path, "/libart.so") || endsWith(path, "/libsigchain.so")) {
+        return CodeOrigin::Runtime;
+    }
+    if (endsWith(path, ".oat") || endsWith(path, ".odex")) {
+        return CodeOrigin::CompiledDex;
+    }
+    for (const char* prefix : kSystemPrefixes) {
+        if (startsWith(path, prefix)) {
+            return CodeOrigin::SystemLibrary;
+        }
+    }
+    if (startsWith(path, "/data/app/") && (endsWith(path, ".so") || endsWith(path, ".apk"))) {
+        return CodeOrigin::AppLibrary;
+    }
+    if (path[0] == '[' && !startsWith(path, "[anon:")) {
+        // [vdso]、[vectors] 等内核提供的映射
+        return CodeOrigin::SystemLibrary;
+    }
+    return startsWith(path, "[anon:") ? CodeOrigin::Anonymous : CodeOrigin::Other;
+}
+
+const char* ModuleIndex::originName(CodeOrigin origin) {
+    switch (origin) {
+        case CodeOrigin::Unmapped: return "unmapped";
+        case CodeOrigin::Runtime: return "runtime";
+        case CodeOrigin::CompiledDex: return "compiled-dex";
+        case CodeOrigin::Jit: return "jit";
+        case CodeOrigin::SystemLibrary: return "system-library";
+        case CodeOrigin::AppLibrary: return "app-library";
+        case CodeOrigin::Anonymous: return "anonymous";
+        case CodeOrigin::Other: return "other";
+    }
+    return "?";
+}
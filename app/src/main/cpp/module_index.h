@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "native_api.h"
+#include "proc_maps.h"
+
+NATIVE_API_BEGIN
+
+/**
+ * 代码地址的来源分类
+ */
+enum class CodeOrigin : uint8_t {
+    Unmapped,       // 不在任何映射内
+    Runtime,        // libart.so / libsigchain.so
+    CompiledDex,    // boot image 或应用的 .oat/.odex
+    Jit,            // JIT 代码缓存
+    SystemLibrary,  // /system、/apex、/vendor 等只读分区上的 .so
+    AppLibrary,     // 本应用 /data/app 下的 .so（含直接从 APK 加载的）
+    Anonymous,      // 无名匿名内存
+    Other           // 其它文件，包括 /data/local/tmp 等可写位置
+};
+
+/**
+ * 地址索引：基于 maps 快照的二分查找，按路径驻留 id 缓存分类结果
+ * 同一个库的多段映射只做一次字符串分类
+ */
+class ModuleIndex {
+public:
+    explicit ModuleIndex(const MapsSnapshot& maps);
+
+    CodeOrigin classify(uintptr_t addr) const;
+
+    /**
+     * 地址所在映射的路径，未映射时返回空串
+     */
+    const std::string& pathOf(uintptr_t addr) const;
+
+    static const char* originName(CodeOrigin origin);
+
+private:
+    CodeOrigin classifyPath(uint32_t pathId) const;
+
+    const MapsSnapshot& maps_;
+    mutable std::vector<uint8_t> origins_;
+};
+
+NATIVE_API_END
@@ -0,0 +1,427 @@
+#include "monitor.h"
+
+#include <jni.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <sched.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <android/log.h>
+
+#include "event_log.h"
+#include "proc_utils.h"
+#include "scan_context.h"
+#include "sys_io.h"
+#include "timing_probe.h"
+
+#define LOG_TAG "Monitor"
+#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+
+// 外部声明后台监控每轮执行的轻量检测
+extern bool checkTracerPid();
+extern bool checkFridaThreads();
+extern bool checkSignalHandlers();
+extern bool checkCodeBreakpoints();
+
+namespace {
+
+// 间隔：有风险时收紧到最短，结果稳定时逐次翻倍直到最长
+constexpr int64_t kMinIntervalMs = 5 * 1000;
+constexpr int64_t kInitialIntervalMs = 30 * 1000;
+constexpr int64_t kMaxIntervalMs = 15 * 60 * 1000;
+
+// 有风险但结果未变化时的间隔
+constexpr int64_t kRiskIntervalMs = 4 * kMinIntervalMs;
+
+// 每个温区检查的 trip point 数量上限
+constexpr int kMaxTripPoints = 16;
+
+constexpr int kMaxCpus = 32;
+
+// 风险掩码是 64 位，检测项最多这么多
+constexpr size_t kMaxChecks = 64;
+
+/**
+ * 每轮执行的检测，结果按位组成风险掩码
+ */
+struct MonitorCheck {
+    const char* name;
+    bool (*run)();
+};
+
+/**
+ * 已注册的检测：只追加不删除，先写表项再发布数量，监控线程无锁读取
+ */
+MonitorCheck g_checks[kMaxChecks] = {
+        {"tracer", checkTracerPid},
+        {"frida threads", checkFridaThreads},
+        {"signal handlers", checkSignalHandlers},
+        {"code breakpoints", checkCodeBreakpoints}
+};
+std::atomic<size_t> g_checkCount{4};
+std::mutex g_registerMutex;
+
+/**
+ * 监控线程状态；统计字段由监控线程写、报告接口读，都用原子变量
+ * lifecycle 串行化启动和停止：停止在持有它的情况下 join，
+ * 线程退出之前新的启动不会清掉 stopRequested
+ */
+struct MonitorState {
+    std::mutex lifecycle;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::thread thread;
+    bool running = false;
+    bool stopRequested = false;
+
+    std::atomic<int64_t> startedAtNs{0};
+    std::atomic<int64_t> cpuNs{0};
+    std::atomic<int64_t> ticks{0};
+    std::atomic<int64_t> thermalPauses{0};
+    std::atomic<int64_t> intervalMs{kInitialIntervalMs};
+    std::atomic<int64_t> riskMask{0};
+    std::atomic<int64_t> littleCores{0};
+};
+
+MonitorState g_monitor;
+
+/**
+ * 读取 sysfs 中只有一个整数的小文件，读不到返回 -1
+ */
+long readSysfsLong(const char* path) {
+    int fd = sysio::openat(AT_FDCWD, path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return -1;
+    char buffer[32];
+    ssize_t n = sysio::read(fd, buffer, sizeof(buffer) - 1);
+    sysio::close(fd);
+    if (n <= 0) return -1;
+    buffer[n] = '\0';
+    return strtol(buffer, nullptr, 10);
+}
+
+bool readSysfsString(const char* path, char* out, size_t size) {
+    int fd = sysio::openat(AT_FDCWD, path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    ssize_t n = sysio::read(fd, out, size - 1);
+    sysio::close(fd);
+    if (n <= 0) return false;
+    out[n] = '\0';
+    return true;
+}
+
+/**
+ * 找出小核：优先用调度器的 cpu_capacity，没有时用 cpufreq 的最高频率
+ * 所有核相同（非异构）时返回 0，不限制亲和性
+ */
+int selectLittleCores(cpu_set_t& set) {
+    long cpus = std::min<long>(sysconf(_SC_NPROCESSORS_CONF), kMaxCpus);
+    long capacity[kMaxCpus];
+    const char* const sources[] = {
+            "/sys/devices/system/cpu/cpu%ld/cpu_capacity",
+            "/sys/devices/system/cpu/cpu%ld/cpufreq/cpuinfo_max_freq"
+    };
+
+    for (const char* source : sources) {
+        long minCapacity = -1;
+        long maxCapacity = -1;
+        bool complete = cpus > 0;
+        for (long cpu = 0; cpu < cpus && complete; cpu++) {
+            char path[96];
+            snprintf(path, sizeof(path), source, cpu);
+            capacity[cpu] = readSysfsLong(path);
+            complete = capacity[cpu] > 0;
+            if (complete) {
+                minCapacity = minCapacity < 0 ? capacity[cpu] : std::min(minCapacity, capacity[cpu]);
+                maxCapacity = std::max(maxCapacity, capacity[cpu]);
+            }
+        }
+        if (!complete) continue;
+        if (minCapacity == maxCapacity) return 0;
+
+        CPU_ZERO(&set);
+        int selected = 0;
+        for (long cpu = 0; cpu < cpus; cpu++) {
+            if (capacity[cpu] == minCapacity) {
+                CPU_SET(cpu, &set);
+                selected++;
+            }
+        }
+        return selected;
+    }
+    return 0;
+}
+
+/**
+ * 当前线程降到最低优先级并绑定到小核
+ */
+void applyBackgroundPolicy() {
+    struct sched_param param{};
+    if (sched_setscheduler(0, SCHED_IDLE, &param) != 0) {
+        // 部分内核不允许应用切换调度类，退回 nice 19
+        setpriority(PRIO_PROCESS, static_cast<id_t>(gettid()), 19);
+    }
+
+    cpu_set_t set;
+    int littleCores = selectLittleCores(set);
+    if (littleCores > 0 && sched_setaffinity(0, sizeof(set), &set) == 0) {
+        g_monitor.littleCores.store(littleCores, std::memory_order_relaxed);
+    }
+    LOGD("Monitor thread policy applied, little cores: %d", littleCores);
+}
+
+bool isCpuThermalType(const char* type) {
+    return strstr(type, "cpu") != nullptr || strstr(type, "CPU") != nullptr;
+}
+
+/**
+ * 温区是否已经越过它的被动降温（passive）或更高的 trip point
+ * 这是内核自己开始降频的温度；各机型的阈值差别很大，不用固定温度判断
+ */
+bool isZoneAboveTripPoint(const char* zone) {
+    char path[128];
+    snprintf(path, sizeof(path), "/sys/class/thermal/%s/temp", zone);
+    long temp = readSysfsLong(path);
+    if (temp <= 0) return false;
+
+    for (int trip = 0; trip < kMaxTripPoints; trip++) {
+        char type[32];
+        snprintf(path, sizeof(path), "/sys/class/thermal/%s/trip_point_%d_type", zone, trip);
+        if (!readSysfsString(path, type, sizeof(type))) break;
+        if (strncmp(type, "passive", 7) != 0 && strncmp(type, "hot", 3) != 0 &&
+            strncmp(type, "critical", 8) != 0) {
+            continue;
+        }
+        snprintf(path, sizeof(path), "/sys/class/thermal/%s/trip_point_%d_temp", zone, trip);
+        long tripTemp = readSysfsLong(path);
+        if (tripTemp > 0 && temp >= tripTemp) return true;
+    }
+    return false;
+}
+
+/**
+ * 降频：CPU 相关的冷却设备处于激活状态，或 CPU 温区越过了降温 trip point
+ * Android 10 起 /sys/class/thermal 可能对应用不可读，读不到时视为正常
+ */
+bool isThermallyThrottled() {
+    bool throttled = false;
+    forEachDirEntry("/sys/class/thermal", [&throttled](const sysio::Dirent64& entry) {
+        char path[128];
+        char type[64];
+        snprintf(path, sizeof(path), "/sys/class/thermal/%s/type", entry.d_name);
+        if (!readSysfsString(path, type, sizeof(type)) || !isCpuThermalType(type)) {
+            return true;
+        }
+
+        if (strncmp(entry.d_name, "cooling_device", 14) == 0) {
+            snprintf(path, sizeof(path), "/sys/class/thermal/%s/cur_state", entry.d_name);
+            throttled = readSysfsLong(path) > 0;
+        } else if (strncmp(entry.d_name, "thermal_zone", 12) == 0) {
+            throttled = isZoneAboveTripPoint(entry.d_name);
+        }
+        return !throttled;
+    });
+    return throttled;
+}
+
+int64_t threadCpuNs() {
+    struct timespec ts{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+/**
+ * 执行一轮检测，返回风险掩码
+ */
+int64_t runTick(ScanContext& context) {
+    context.reset();
+    int64_t mask = 0;
+    size_t count = g_checkCount.load(std::memory_order_acquire);
+    for (size_t i = 0; i < count; i++) {
+        if (g_checks[i].run()) {
+            mask |= int64_t{1} << i;
+        }
+    }
+    return mask;
+}
+
+/**
+ * 根据本轮与上一轮的风险掩码调整间隔
+ * 出现新的风险立即收紧；风险持续时保持较短间隔；一直干净时逐次翻倍
+ */
+int64_t nextInterval(int64_t interval, int64_t previousMask, int64_t mask) {
+    if ((mask & ~previousMask) != 0) {
+        return kMinIntervalMs;
+    }
+    if (mask != 0) {
+        return kRiskIntervalMs;
+    }
+    return std::min(interval * 2, kMaxIntervalMs);
+}
+
+void monitorLoop() {
+    applyBackgroundPolicy();
+    ScanContext context;
+    ScanContextScope scope(context);
+
+    int64_t interval = kInitialIntervalMs;
+    int64_t previousMask = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(g_monitor.mutex);
+            g_monitor.wake.wait_for(lock, std::chrono::milliseconds(interval),
+                                    [] { return g_monitor.stopRequested; });
+            if (g_monitor.stopRequested) break;
+        }
+
+        int64_t cpuStart = threadCpuNs();
+        if (isThermallyThrottled()) {
+            // 降频期间跳过这一轮，按当前间隔再来看，不因为一次降频拉长整个节奏
+            g_monitor.thermalPauses.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            int64_t mask = runTick(context);
+            interval = nextInterval(interval, previousMask, mask);
+            if (mask != previousMask) {
+                EVLOG_W(MonitorRiskChanged, previousMask, mask, interval);
+            }
+            previousMask = mask;
+            g_monitor.riskMask.store(mask, std::memory_order_relaxed);
+            g_monitor.ticks.fetch_add(1, std::memory_order_relaxed);
+        }
+        g_monitor.intervalMs.store(interval, std::memory_order_relaxed);
+        g_monitor.cpuNs.fetch_add(threadCpuNs() - cpuStart, std::memory_order_relaxed);
+    }
+}
+
+} // namespace
+
+void registerMonitorCheck(const char* name, bool (*run)()) {
+    std::lock_guard<std::mutex> lock(g_registerMutex);
+    size_t count = g_checkCount.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < count; i++) {
+        if (g_checks[i].run == run) {
+            return;
+        }
+    }
+    if (count == kMaxChecks) {
+        LOGD("Monitor check table full, ignoring %s", name);
+        return;
+    }
+    g_checks[count] = {name, run};
+    g_checkCount.store(count + 1, std::memory_order_release);
+}
+
+/**
+ * 启动后台监控线程；已在运行时不重复启动
+ */
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_grtsinry43_environmentdetector_security_NativeSecurityDetector_nativeStartMonitor(
+        JNIEnv* env,
+        jclass clazz) {
+
+    std::lock_guard<std::mutex> lifecycle(g_monitor.lifecycle);
+    std::lock_guard<std::mutex> lock(g_monitor.mutex);
+    if (g_monitor.running) {
+        return;
+    }
+    g_monitor.running = true;
+    g_monitor.stopRequested = false;
+    g_monitor.startedAtNs.store(monotonicNowNs(), std::memory_order_relaxed);
+    g_monitor.thread = std::thread(monitorLoop);
+    EVLOG_I(CheckStarted, CheckId::Monitor);
+}
+
+/**
+ * 停止后台监控线程并等待其退出；线程退出后才允许再次启动
+ */
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_grtsinry43_environmentdetector_security_NativeSecurityDetector_nativeStopMonitor(
+        JNIEnv* env,
+        jclass clazz) {
+
+    // 监控线程只用 mutex，不碰 lifecycle，持有它 join 不会死锁
+    std::lock_guard<std::mutex> lifecycle(g_monitor.lifecycle);
+    {
+        std::lock_guard<std::mutex> lock(g_monitor.mutex);
+        if (!g_monitor.running) {
+            return;
+        }
+        g_monitor.stopRequested = true;
+    }
+    g_monitor.wake.notify_all();
+    g_monitor.thread.join();
+
+    std::lock_guard<std::mutex> lock(g_monitor.mutex);
+    g_monitor.running = false;
+}
+
+/**
+ * 监控报告，顺序：
+ * 检测轮数、因降频暂停次数、当前间隔（毫秒）、风险掩码、小核数量、
+ * 累计 CPU 时间（微秒）、运行时长（毫秒）、折算的每小时 CPU 毫秒数
+ */
+extern "C"
+JNIEXPORT jlongArray JNICALL
+Java_com_grtsinry43_environmentdetector_security_NativeSecurityDetector_nativeGetMonitorReport(
+        JNIEnv* env,
+        jclass clazz) {
+
+    int64_t startedAt = g_monitor.startedAtNs.load(std::memory_order_relaxed);
+    int64_t wallNs = startedAt != 0 ? monotonicNowNs() - startedAt : 0;
+    int64_t cpuNs = g_monitor.cpuNs.load(std::memory_order_relaxed);
+    constexpr double kNsPerHour = 3600.0 * 1e9;
+    int64_t cpuMsPerHour = wallNs > 0 ? static_cast<int64_t>(cpuNs / 1e6 * (kNsPerHour / wallNs)) : 0;
+
+    const jlong values[] = {
+            g_monitor.ticks.load(std::memory_order_relaxed),
+            g_monitor.thermalPauses.load(std::memory_order_relaxed),
+            g_monitor.intervalMs.load(std::memory_order_relaxed),
+            g_monitor.riskMask.load(std::memory_order_relaxed),
+            g_monitor.littleCores.load(std::memory_order_relaxed),
+            cpuNs / 1000,
+            wallNs / 1000000,
+            cpuMsPerHour
+    };
+
+    jlongArray result = env->NewLongArray(sizeof(values) / sizeof(values[0]));
+    if (result != nullptr) {
+        env->SetLongArrayRegion(result, 0, sizeof(values) / sizeof(values[0]), values);
+    }
+    return result;
+}
+
+/**
+ * 最近一轮检测中报告风险的检测项名称，没有风险或监控未运行过时为空数组
+ */
+extern "C"
+JNIEXPORT jobjectArray JNICALL
+Java_com_grtsinry43_environmentdetector_security_NativeSecurityDetector_nativeGetMonitorRisks(
+        JNIEnv* env,
+        jclass clazz) {
+
+    int64_t mask = g_monitor.riskMask.load(std::memory_order_relaxed);
+    size_t count = g_checkCount.load(std::memory_order_acquire);
+    jsize risks = 0;
+    for (size_t i = 0; i < count; i++) {
+        if ((mask >> i) & 1) risks++;
+    }
+
+    jclass stringClass = env->FindClass("java/lang/String");
+    jobjectArray result = env->NewObjectArray(risks, stringClass, nullptr);
+    jsize index = 0;
+    for (size_t i = 0; result != nullptr && i < count; i++) {
+        if (((mask >> i) & 1) == 0) continue;
+        jstring name = env->NewStringUTF(g_checks[i].name);
+        env->SetObjectArrayElement(result, index++, name);
+        env->DeleteLocalRef(name);
+    }
+    env->DeleteLocalRef(stringClass);
+    return result;
+}
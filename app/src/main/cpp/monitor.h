@@ -0,0 +1,14 @@
+#pragma once
+
+#include "native_api.h"
+
+NATIVE_API_BEGIN
+
+/**
+ * 把一项轻量检测加入后台监控，每轮执行一次，结果占风险掩码中的一位（按注册顺序）
+ * 引导库自带的检测静态注册；按需加载的扫描模块在自己的 JNI_OnLoad 中注册
+ * 重复注册同一个函数会被忽略
+ */
+void registerMonitorCheck(const char* name, bool (*run)());
+
+NATIVE_API_END
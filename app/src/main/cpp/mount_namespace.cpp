@@ -0,0 +1,284 @@
+#include <jni.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <unistd.h>
+#include <android/log.h>
+
+#include "event_log.h"
+#include "proc_snapshot.h"
+#include "proc_utils.h"
+
+#define LOG_TAG "MountNamespace"
+#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN, LOG_TAG, __VA_ARGS__)
+
+namespace {
+
+/**
+ * mountinfo 一行中我们关心的字段（指向原始缓冲区，不拷贝）
+ * 格式：id parent major:minor root mountpoint options [optional...] - fstype source superopts
+ */
+struct MountEntryView {
+    const char* root = nullptr;
+    size_t rootLen = 0;
+    const char* mountPoint = nullptr;
+    size_t mountPointLen = 0;
+    const char* fsType = nullptr;
+    size_t fsTypeLen = 0;
+    const char* source = nullptr;
+    size_t sourceLen = 0;
+};
+
+// 只比较系统分区相关的挂载点
+// /storage、/mnt、/data 在每个应用的命名空间里本来就不同，比较它们只会误报
+const char* const kComparedPrefixes[] = {
+        "/system",
+        "/vendor",
+        "/product",
+        "/system_ext",
+        "/odm",
+        "/sbin",
+        "/debug_ramdisk"
+};
+
+bool hasPrefix(const char* str, size_t len, const char* prefix) {
+    size_t prefixLen = strlen(prefix);
+    if (len < prefixLen || memcmp(str, prefix, prefixLen) != 0) {
+        return false;
+    }
+    // 前缀必须以路径边界结束，避免 /systemfoo 这种匹配
+    return len == prefixLen || str[prefixLen] == '/';
+}
+
+bool contains(const char* str, size_t len, const char* needle) {
+    size_t needleLen = strlen(needle);
+    if (needleLen == 0 || len < needleLen) return false;
+    for (size_t i = 0; i + needleLen <= len; i++) {
+        if (memcmp(str + i, needle, needleLen) == 0) return true;
+    }
+    return false;
+}
+
+bool parseMountInfoLine(const char* line, size_t len, MountEntryView& out) {
+    const char* fields[6];
+    size_t lengths[6];
+    size_t fieldCount = 0;
+
+    const char* p = line;
+    const char* end = line + len;
+
+    // 前 5 个字段位置固定
+    while (p < end && fieldCount < 5) {
+        const char* start = p;
+        while (p < end && *p != ' ') p++;
+        fields[fieldCount] = start;
+        lengths[fieldCount] = static_cast<size_t>(p - start);
+        fieldCount++;
+        if (p < end) p++;
+    }
+    if (fieldCount < 5) return false;
+
+    out.root = fields[3];
+    out.rootLen = lengths[3];
+    out.mountPoint = fields[4];
+    out.mountPointLen = lengths[4];
+
+    // 跳过 options 和可变数量的 optional fields，直到分隔符 "-"
+    for (;;) {
+        if (p >= end) return false;
+        const char* start = p;
+        while (p < end && *p != ' ') p++;
+        bool isSeparator = (p - start == 1 && *start == '-');
+        if (p < end) p++;
+        if (isSeparator) break;
+    }
+
+    // fstype 和 source
+    fieldCount = 0;
+    while (p < end && fieldCount < 2) {
+        const char* start = p;
+        while (p < end && *p != ' ') p++;
+        fields[fieldCount] = start;
+        lengths[fieldCount] = static_cast<size_t>(p - start);
+        fieldCount++;
+        if (p < end) p++;
+    }
+    if (fieldCount < 2) return false;
+
+    out.fsType = fields[0];
+    out.fsTypeLen = lengths[0];
+    out.source = fields[1];
+    out.sourceLen = lengths[1];
+    return true;
+}
+
+bool isComparedMount(const MountEntryView& entry) {
+    for (const char* prefix : kComparedPrefixes) {
+        if (hasPrefix(entry.mountPoint, entry.mountPointLen, prefix)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * 挂载条目指纹：root + mountpoint + fstype + source
+ * 不包含 mount id 和 options，它们在不同命名空间里天然不同
+ */
+uint64_t hashMountEntry(const MountEntryView& entry) {
+    uint64_t hash = fnv1a64(entry.root, entry.rootLen);
+    hash = fnv1a64("\0", 1, hash);
+    hash = fnv1a64(entry.mountPoint, entry.mountPointLen, hash);
+    hash = fnv1a64("\0", 1, hash);
+    hash = fnv1a64(entry.fsType, entry.fsTypeLen, hash);
+    hash = fnv1a64("\0", 1, hash);
+    return fnv1a64(entry.source, entry.sourceLen, hash);
+}
+
+/**
+ * Magisk / KernelSU 在自身命名空间中留下的挂载特征
+ */
+bool isRootMountSignature(const MountEntryView& entry) {
+    return contains(entry.source, entry.sourceLen, "magisk") ||
+           contains(entry.source, entry.sourceLen, "KSU") ||
+           contains(entry.root, entry.rootLen, "/adb/modules") ||
+           contains(entry.root, entry.rootLen, "/.magisk") ||
+           hasPrefix(entry.mountPoint, entry.mountPointLen, "/debug_ramdisk");
+}
+
+/**
+ * 解析 mountinfo，收集需要比较的条目指纹，并统计 root 特征条目
+ */
+void collectMountHashes(const std::string& content,
+                        std::vector<uint64_t>& hashes,
+                        int& signatureCount) {
+    hashes.clear();
+    signatureCount = 0;
+
+    const char* p = content.data();
+    const char* end = p + content.size();
+    while (p < end) {
+        const char* lineEnd = static_cast<const char*>(memchr(p, '\n', static_cast<size_t>(end - p)));
+        if (lineEnd == nullptr) lineEnd = end;
+
+        MountEntryView entry;
+        if (parseMountInfoLine(p, static_cast<size_t>(lineEnd - p), entry)) {
+            if (isRootMountSignature(entry)) {
+                signatureCount++;
+            }
+            if (isComparedMount(entry)) {
+                hashes.push_back(hashMountEntry(entry));
+            }
+        }
+        p = lineEnd + 1;
+    }
+
+    std::sort(hashes.begin(), hashes.end());
+}
+
+/**
+ * 有序多重集合差：统计 reference 中存在而 self 中缺失的条目数
+ */
+int countMissingEntries(const std::vector<uint64_t>& self,
+                        const std::vector<uint64_t>& reference) {
+    int missing = 0;
+    size_t i = 0;
+    size_t j = 0;
+    while (j < reference.size()) {
+        if (i < self.size() && self[i] < reference[j]) {
+            i++;
+        } else if (i < self.size() && self[i] == reference[j]) {
+            i++;
+            j++;
+        } else {
+            missing++;
+            j++;
+        }
+    }
+    return missing;
+}
+
+} // namespace
+
+/**
+ * 检测 Root：挂载命名空间比较
+ * 将本进程的 mountinfo 与 init（或 zygote）的 mountinfo 做集合差，
+ * 系统分区上的挂载在我们的命名空间中被卸载，说明存在 DenyList 之类的隐藏手段
+ */
+bool checkMountNamespace() {
+    ProcSnapshot& snapshot = currentSnapshot();
+    if (!snapshot.available(ProcFile::MountInfo)) {
+        return false;
+    }
+    const std::string& selfContent = snapshot.get(ProcFile::MountInfo);
+
+    std::vector<uint64_t> selfHashes;
+    int signatureCount = 0;
+    collectMountHashes(selfContent, selfHashes, signatureCount);
+
+    if (signatureCount > 0) {
+        LOGW("Root mount signature in own namespace: %d entries", signatureCount);
+        return true;
+    }
+
+    std::string selfNs;
+    readLinkString("/proc/self/ns/mnt", selfNs);
+
+    // 参考进程：优先 init，其次父进程（应用进程的父进程是 zygote）
+    // 父进程号取自快照中的 status 而不是 getppid()，这样所有输入都是文件，可以离线重放
+    std::string ppid;
+    char parentPath[64] = "";
+    if (findStatusField(snapshot.get(ProcFile::Status), "PPid", ppid)) {
+        snprintf(parentPath, sizeof(parentPath), "/proc/%d", atoi(ppid.c_str()));
+    }
+    const char* referenceRoots[] = {"/proc/1", parentPath};
+
+    for (const char* referenceRoot : referenceRoots) {
+        if (referenceRoot[0] == '\0') continue;
+        std::string path = std::string(referenceRoot) + "/mountinfo";
+        std::string referenceContent;
+        if (!readFileFully(path.c_str(), referenceContent) || referenceContent.empty()) {
+            continue;
+        }
+
+        std::string referenceNs;
+        path = std::string(referenceRoot) + "/ns/mnt";
+        if (!selfNs.empty() && readLinkString(path.c_str(), referenceNs) && referenceNs == selfNs) {
+            // 同一个命名空间，不存在差异
+            LOGD("Sharing mount namespace with %s", referenceRoot);
+            return false;
+        }
+
+        std::vector<uint64_t> referenceHashes;
+        int referenceSignatures = 0;
+        collectMountHashes(referenceContent, referenceHashes, referenceSignatures);
+
+        int missing = countMissingEntries(selfHashes, referenceHashes);
+        if (missing > 0) {
+            LOGW("%d system mounts of %s missing in own namespace (%d root signatures there)",
+                 missing, referenceRoot, referenceSignatures);
+            return true;
+        }
+        return false;
+    }
+
+    return false;
+}
+
+extern "C"
+JNIEXPORT jboolean JNICALL
+Java_com_grtsinry43_environmentdetector_security_NativeSecurityDetector_nativeCheckMountNamespace(
+        JNIEnv* env,
+        jclass clazz) {
+
+    EVLOG_D(CheckStarted, CheckId::MountNamespace);
+
+    bool tampered = checkMountNamespace();
+
+    EVLOG_I(CheckResult, CheckId::MountNamespace, tampered);
+    return tampered;
+}
@@ -0,0 +1,167 @@
+#include <jni.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <android/log.h>
+
+#include "event_log.h"
+#include "proc_snapshot.h"
+#include "proc_utils.h"
+
+#define LOG_TAG "NamespaceProbe"
+#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN, LOG_TAG, __VA_ARGS__)
+
+namespace {
+
+/**
+ * 内核为初始命名空间分配的固定 inode（include/linux/proc_ns.h）
+ * Android 应用进程与 init 共享这些命名空间，不一致说明运行在容器中
+ */
+struct InitNamespace {
+    const char* name;
+    unsigned long inode;
+};
+
+const InitNamespace kInitNamespaces[] = {
+        {"ipc",    0xEFFFFFFFUL},
+        {"uts",    0xEFFFFFFEUL},
+        {"user",   0xEFFFFFFDUL},
+        {"pid",    0xEFFFFFFCUL},
+        {"cgroup", 0xEFFFFFFBUL}
+};
+
+// 容器运行时在 cgroup 路径中留下的特征
+const char* const kContainerCgroupKeywords[] = {
+        "docker",
+        "lxc",
+        "kubepods",
+        "containerd",
+        "libpod",
+        "anbox",
+        "redroid",
+        "waydroid"
+};
+
+/**
+ * 解析 "pid:[4026531836]" 形式的命名空间链接
+ */
+bool parseNamespaceInode(const std::string& link, unsigned long& inode) {
+    size_t open = link.find('[');
+    if (open == std::string::npos) {
+        return false;
+    }
+    char* end = nullptr;
+    inode = strtoul(link.c_str() + open + 1, &end, 10);
+    return end != nullptr && *end == ']';
+}
+
+/**
+ * 检查是否处于非初始的 pid/user/uts/ipc/cgroup 命名空间
+ */
+bool checkNamespaceInodes() {
+    char path[64];
+    std::string link;
+    for (const InitNamespace& ns : kInitNamespaces) {
+        snprintf(path, sizeof(path), "/proc/self/ns/%s", ns.name);
+        unsigned long inode = 0;
+        // 旧内核没有 cgroup 命名空间，读不到就跳过
+        if (!readLinkString(path, link) || !parseNamespaceInode(link, inode)) {
+            continue;
+        }
+        if (inode != ns.inode) {
+            LOGW("Non-initial %s namespace: %s", ns.name, link.c_str());
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * uid_map 在初始 user 命名空间中恒为 "0 0 4294967295"
+ */
+bool checkUidMap(const std::string& content) {
+    unsigned long inside = 0;
+    unsigned long outside = 0;
+    unsigned long length = 0;
+    int lines = 0;
+
+    size_t pos = 0;
+    while (pos < content.size()) {
+        size_t lineEnd = content.find('\n', pos);
+        if (lineEnd == std::string::npos) lineEnd = content.size();
+        if (lineEnd > pos) {
+            if (sscanf(content.c_str() + pos, "%lu %lu %lu", &inside, &outside, &length) != 3) {
+                return false;
+            }
+            lines++;
+        }
+        pos = lineEnd + 1;
+    }
+
+    if (lines != 1 || inside != 0 || outside != 0 || length != 4294967295UL) {
+        LOGW("Remapped uid_map (%d ranges, first %lu -> %lu)", lines, inside, outside);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * NSpid 有多个值说明进程位于嵌套的 pid 命名空间
+ */
+bool checkNsPid(const std::string& status) {
+    std::string nsPid;
+    if (!findStatusField(status, "NSpid", nsPid)) {
+        return false;
+    }
+    if (nsPid.find_first_of(" \t") != std::string::npos) {
+        LOGW("Nested pid namespace: NSpid=%s", nsPid.c_str());
+        return true;
+    }
+    return false;
+}
+
+bool checkCgroup(const std::string& content) {
+    for (const char* keyword : kContainerCgroupKeywords) {
+        if (content.find(keyword) != std::string::npos) {
+            LOGW("Container cgroup path detected: %s", keyword);
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+/**
+ * 检测虚拟化环境：命名空间与 cgroup 指纹
+ * 用于识别 Android 容器、云手机以及在独立命名空间中运行的沙箱
+ */
+bool checkNamespaceFingerprint() {
+    ProcSnapshot& snapshot = currentSnapshot();
+    snapshot.prefetch({ProcFile::Status, ProcFile::Cgroup, ProcFile::UidMap});
+
+    bool detected = false;
+
+    if (checkNamespaceInodes()) detected = true;
+    if (snapshot.available(ProcFile::UidMap) && checkUidMap(snapshot.get(ProcFile::UidMap))) detected = true;
+    if (checkNsPid(snapshot.get(ProcFile::Status))) detected = true;
+    if (checkCgroup(snapshot.get(ProcFile::Cgroup))) detected = true;
+
+    return detected;
+}
+
+extern "C"
+JNIEXPORT jboolean JNICALL
+Java_com_grtsinry43_environmentdetector_security_NativeSecurityDetector_nativeCheckVirtualEnvironment(
+        JNIEnv* env,
+        jclass clazz) {
+
+    EVLOG_D(CheckStarted, CheckId::VirtualEnvironment);
+
+    bool isVirtual = checkNamespaceFingerprint();
+
+    EVLOG_I(CheckResult, CheckId::VirtualEnvironment, isVirtual);
+    return isVirtual;
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+/**
+ * 引导库导出给扫描模块的接口
+ * 发布版本以 -fvisibility=hidden 编译，引导库中被扫描模块（libscanner_*.so）链接的公共设施
+ * （sysio、procfs 快照、扫描上下文、事件日志、基线等）需要显式导出；
+ * 在头文件的声明部分包上 NATIVE_API_BEGIN / NATIVE_API_END，其余内部符号保持隐藏
+ */
+#define NATIVE_API_BEGIN _Pragma("GCC visibility push(default)")
+#define NATIVE_API_END _Pragma("GCC visibility pop")
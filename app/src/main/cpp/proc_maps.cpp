@@ -0,0 +1,163 @@
+#include "proc_maps.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+inline int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+const char* parseHex(const char* p, const char* end, uint64_t& value) {
+    value = 0;
+    const char* start = p;
+    while (p < end) {
+        int digit = hexValue(*p);
+        if (digit < 0) break;
+        value = (value << 4) | static_cast<uint64_t>(digit);
+        p++;
+    }
+    return p == start ? nullptr : p;
+}
+
+const char* parseDec(const char* p, const char* end, uint64_t& value) {
+    value = 0;
+    const char* start = p;
+    while (p < end && *p >= '0' && *p <= '9') {
+        value = value * 10 + static_cast<uint64_t>(*p - '0');
+        p++;
+    }
+    return p == start ? nullptr : p;
+}
+
+const char* skipSpaces(const char* p, const char* end) {
+    while (p < end && *p == ' ') p++;
+    return p;
+}
+
+} // namespace
+
+PathInterner::PathInterner() {
+    paths_.emplace_back();
+    ids_.emplace(std::string_view(paths_.back()), 0);
+}
+
+uint32_t PathInterner::intern(const char* path, size_t len) {
+    auto it = ids_.find(std::string_view(path, len));
+    if (it != ids_.end()) {
+        return it->second;
+    }
+    uint32_t id = static_cast<uint32_t>(paths_.size());
+    paths_.emplace_back(path, len);
+    ids_.emplace(std::string_view(paths_.back()), id);
+    return id;
+}
+
+void PathInterner::clear() {
+    ids_.clear();
+    paths_.clear();
+    paths_.emplace_back();
+    ids_.emplace(std::string_view(paths_.back()), 0);
+}
+
+bool parseMapsLine(const char* line, size_t len, MapEntry& entry,
+                   const char*& pathStart, size_t& pathLen) {
+    const char* p = line;
+    const char* end = line + len;
+    uint64_t value = 0;
+
+    if ((p = parseHex(p, end, value)) == nullptr || p >= end || *p != '-') return false;
+    entry.start = static_cast<uintptr_t>(value);
+    if ((p = parseHex(p + 1, end, value)) == nullptr) return false;
+    entry.end = static_cast<uintptr_t>(value);
+
+    p = skipSpaces(p, end);
+    if (end - p < 4) return false;
+    entry.perms = 0;
+    if (p[0] == 'r') entry.perms |= kMapRead;
+    if (p[1] == 'w') entry.perms |= kMapWrite;
+    if (p[2] == 'x') entry.perms |= kMapExec;
+    if (p[3] == 's') entry.perms |= kMapShared;
+    p += 4;
+
+    p = skipSpaces(p, end);
+    if ((p = parseHex(p, end, entry.offset)) == nullptr) return false;
+
+    // dev 字段 "fd:05"，直接跳过
+    p = skipSpaces(p, end);
+    while (p < end && *p != ' ') p++;
+
+    p = skipSpaces(p, end);
+    if ((p = parseDec(p, end, entry.inode)) == nullptr) return false;
+
+    p = skipSpaces(p, end);
+    pathStart = p;
+    pathLen = static_cast<size_t>(end - p);
+    return true;
+}
+
+void MapsSnapshot::parse(const std::string& content) {
+    clear();
+    entries_.reserve(content.size() / 96);
+
+    const char* p = content.data();
+    const char* end = p + content.size();
+    while (p < end) {
+        const char* lineEnd = static_cast<const char*>(memchr(p, '\n', static_cast<size_t>(end - p)));
+        if (lineEnd == nullptr) lineEnd = end;
+
+        MapEntry entry{};
+        const char* pathStart = nullptr;
+        size_t pathLen = 0;
+        if (parseMapsLine(p, static_cast<size_t>(lineEnd - p), entry, pathStart, pathLen)) {
+            entry.pathId = paths_.intern(pathStart, pathLen);
+            entries_.push_back(entry);
+        }
+        p = lineEnd + 1;
+    }
+}
+
+void MapsSnapshot::parseSmapsHeaders(const std::string& content) {
+    clear();
+    entries_.reserve(content.size() / 1024);
+
+    const char* p = content.data();
+    const char* end = p + content.size();
+    while (p < end) {
+        const char* lineEnd = static_cast<const char*>(memchr(p, '\n', static_cast<size_t>(end - p)));
+        if (lineEnd == nullptr) lineEnd = end;
+
+        // 表头以小写十六进制地址开头，计数行（Size:、Rss:、VmFlags: ...）以大写字母开头
+        if ((*p >= '0' && *p <= '9') || (*p >= 'a' && *p <= 'f')) {
+            MapEntry entry{};
+            const char* pathStart = nullptr;
+            size_t pathLen = 0;
+            if (parseMapsLine(p, static_cast<size_t>(lineEnd - p), entry, pathStart, pathLen)) {
+                entry.pathId = paths_.intern(pathStart, pathLen);
+                entries_.push_back(entry);
+            }
+        }
+        p = lineEnd + 1;
+    }
+}
+
+void MapsSnapshot::clear() {
+    entries_.clear();
+    paths_.clear();
+}
+
+const MapEntry* MapsSnapshot::find(uintptr_t addr) const {
+    auto it = std::upper_bound(entries_.begin(), entries_.end(), addr,
+                               [](uintptr_t value, const MapEntry& entry) {
+                                   return value < entry.start;
+                               });
+    if (it == entries_.begin()) {
+        return nullptr;
+    }
+    --it;
+    return addr < it->end ? &*it : nullptr;
+}
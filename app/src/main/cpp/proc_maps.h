@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "native_api.h"
+
+NATIVE_API_BEGIN
+
+/**
+ * 路径驻留表
+ * maps 中同一个文件往往对应多段映射，驻留后用整数 id 比较，避免重复的字符串比较
+ * id 0 固定表示匿名映射（空路径）
+ */
+class PathInterner {
+public:
+    PathInterner();
+    PathInterner(const PathInterner&) = delete;
+    PathInterner& operator=(const PathInterner&) = delete;
+
+    uint32_t intern(const char* path, size_t len);
+    const std::string& path(uint32_t id) const { return paths_[id]; }
+    size_t size() const { return paths_.size(); }
+    void clear();
+
+private:
+    // deque 保证扩容时已有字符串地址不变，string_view 键才安全
+    std::deque<std::string> paths_;
+    std::unordered_map<std::string_view, uint32_t> ids_;
+};
+
+enum MapPerm : uint8_t {
+    kMapRead = 1 << 0,
+    kMapWrite = 1 << 1,
+    kMapExec = 1 << 2,
+    kMapShared = 1 << 3
+};
+
+/**
+ * /proc/self/maps 中的一段映射
+ */
+struct MapEntry {
+    uintptr_t start;
+    uintptr_t end;
+    uint64_t offset;
+    uint64_t inode;
+    uint32_t pathId;
+    uint8_t perms;
+};
+
+/**
+ * 解析后的 maps 快照，条目按地址升序（内核输出即有序）
+ */
+class MapsSnapshot {
+public:
+    void parse(const std::string& content);
+
+    /**
+     * 从 smaps 中只提取映射表头，每段映射后面的计数行用 memchr 直接跳过
+     */
+    void parseSmapsHeaders(const std::string& content);
+    void clear();
+
+    const std::vector<MapEntry>& entries() const { return entries_; }
+    const PathInterner& paths() const { return paths_; }
+    const std::string& pathOf(const MapEntry& entry) const { return paths_.path(entry.pathId); }
+
+    /**
+     * 二分查找包含 addr 的映射，找不到返回 nullptr
+     */
+    const MapEntry* find(uintptr_t addr) const;
+
+private:
+    std::vector<MapEntry> entries_;
+    PathInterner paths_;
+};
+
+/**
+ * 解析 maps/smaps 的表头行："start-end perms offset dev inode [path]"
+ * 成功时 pathStart/pathLen 指向行内的路径部分
+ */
+bool parseMapsLine(const char* line, size_t len, MapEntry& entry,
+                   const char*& pathStart, size_t& pathLen);
+
+/**
+ * 遍历 smaps，每段映射回调一次 fn(const MapEntry& entry, std::string_view path, uint64_t privateDirtyKb)
+ * 计数行里只解析 Private_Dirty，其余行用 memchr 跳过
+ */
+template <typename Fn>
+void forEachSmapsEntry(const std::string& content, Fn&& fn) {
+    static constexpr char kPrivateDirty[] = "Private_Dirty:";
+    static constexpr size_t kPrivateDirtyLen = sizeof(kPrivateDirty) - 1;
+
+    MapEntry current{};
+    std::string_view currentPath;
+    uint64_t privateDirtyKb = 0;
+    bool hasCurrent = false;
+
+    const char* p = content.data();
+    const char* end = p + content.size();
+    while (p < end) {
+        const char* lineEnd = static_cast<const char*>(memchr(p, '\n', static_cast<size_t>(end - p)));
+        if (lineEnd == nullptr) lineEnd = end;
+        size_t len = static_cast<size_t>(lineEnd - p);
+
+        if ((*p >= '0' && *p <= '9') || (*p >= 'a' && *p <= 'f')) {
+            if (hasCurrent) fn(current, currentPath, privateDirtyKb);
+
+            const char* pathStart = nullptr;
+            size_t pathLen = 0;
+            hasCurrent = parseMapsLine(p, len, current, pathStart, pathLen);
+            currentPath = hasCurrent ? std::string_view(pathStart, pathLen) : std::string_view();
+            privateDirtyKb = 0;
+        } else if (len > kPrivateDirtyLen && memcmp(p, kPrivateDirty, kPrivateDirtyLen) == 0) {
+            const char* digits = p + kPrivateDirtyLen;
+            while (digits < lineEnd && *digits == ' ') digits++;
+            while (digits < lineEnd && *digits >= '0' && *digits <= '9') {
+                privateDirtyKb = privateDirtyKb * 10 + static_cast<uint64_t>(*digits - '0');
+                digits++;
+            }
+        }
+        p = lineEnd + 1;
+    }
+    if (hasCurrent) fn(current, currentPath, privateDirtyKb);
+}
+
+NATIVE_API_END
@@ -0,0 +1,88 @@
+#include "proc_snapshot.h"
+
+#include <cstring>
+
+#include "proc_utils.h"
+
+namespace {
+
+const char* const kProcFilePaths[] = {
+        "/proc/self/status",
+        "/proc/self/maps",
+        "/proc/self/smaps",
+        "/proc/self/mountinfo",
+        "/proc/self/cgroup",
+        "/proc/self/uid_map",
+        "/proc/self/gid_map",
+        "/proc/self/cmdline",
+        "/proc/self/environ"
+};
+
+static_assert(sizeof(kProcFilePaths) / sizeof(kProcFilePaths[0]) ==
+              static_cast<size_t>(ProcFile::Count), "ProcFile path table out of sync");
+
+} // namespace
+
+const std::string& ProcSnapshot::get(ProcFile file) {
+    load(file);
+    return contents_[static_cast<int>(file)];
+}
+
+bool ProcSnapshot::available(ProcFile file) {
+    load(file);
+    return ok_[static_cast<int>(file)];
+}
+
+const MapsSnapshot& ProcSnapshot::maps() {
+    if (!mapsParsed_) {
+        maps_.parse(get(ProcFile::Maps));
+        mapsParsed_ = true;
+    }
+    return maps_;
+}
+
+void ProcSnapshot::prefetch(std::initializer_list<ProcFile> files) {
+    for (ProcFile file : files) {
+        load(file);
+    }
+}
+
+void ProcSnapshot::reset() {
+    for (int i = 0; i < kCount; i++) {
+        contents_[i].clear();
+        loaded_[i] = false;
+        ok_[i] = false;
+    }
+    maps_.clear();
+    mapsParsed_ = false;
+}
+
+void ProcSnapshot::load(ProcFile file) {
+    int index = static_cast<int>(file);
+    if (loaded_[index]) {
+        return;
+    }
+    ok_[index] = readFileFully(kProcFilePaths[index], contents_[index]);
+    loaded_[index] = true;
+}
+
+bool findStatusField(const std::string& content, const char* key, std::string& value) {
+    size_t keyLen = strlen(key);
+    size_t pos = 0;
+    while (pos < content.size()) {
+        size_t lineEnd = content.find('\n', pos);
+        if (lineEnd == std::string::npos) lineEnd = content.size();
+
+        if (lineEnd - pos > keyLen &&
+            content.compare(pos, keyLen, key) == 0 &&
+            content[pos + keyLen] == ':') {
+            size_t start = pos + keyLen + 1;
+            while (start < lineEnd && (content[start] == ' ' || content[start] == '\t')) start++;
+            value.assign(content, start, lineEnd - start);
+            return true;
+        }
+        pos = lineEnd + 1;
+    }
+    value.clear();
+    return false;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <initializer_list>
+#include <string>
+
+#include "native_api.h"
+#include "proc_maps.h"
+
+NATIVE_API_BEGIN
+
+/**
+ * 单次扫描中会被多个检测项读取的 /proc/self 文件
+ */
+enum class ProcFile {
+    Status,
+    Maps,
+    Smaps,
+    MountInfo,
+    Cgroup,
+    UidMap,
+    GidMap,
+    Cmdline,
+    Environ,
+    Count
+};
+
+/**
+ * 每次扫描的 procfs 快照
+ * 同一次扫描内每个文件只读取一次，各检测项共享内容，保证看到的是同一时刻的状态
+ */
+class ProcSnapshot {
+public:
+    /**
+     * 获取文件内容，首次访问时读取；读取失败返回空串
+     */
+    const std::string& get(ProcFile file);
+
+    /**
+     * 文件是否读取成功
+     */
+    bool available(ProcFile file);
+
+    /**
+     * 解析后的 maps，所有基于映射的检测共用这一次解析
+     */
+    const MapsSnapshot& maps();
+
+    /**
+     * 批量预读，一次性把若干文件拉进快照
+     */
+    void prefetch(std::initializer_list<ProcFile> files);
+
+    /**
+     * 丢弃所有缓存内容，开始新的扫描
+     */
+    void reset();
+
+private:
+    void load(ProcFile file);
+
+    static constexpr int kCount = static_cast<int>(ProcFile::Count);
+
+    std::string contents_[kCount];
+    bool loaded_[kCount] = {};
+    bool ok_[kCount] = {};
+
+    MapsSnapshot maps_;
+    bool mapsParsed_ = false;
+};
+
+/**
+ * 当前线程的扫描上下文中的快照（见 scan_context.h）
+ * nativeBeginScan 负责重置
+ */
+ProcSnapshot& currentSnapshot();
+
+/**
+ * 在快照文本中查找 "Key:\t..." 形式的行，返回冒号后去掉前导空白的值
+ */
+bool findStatusField(const std::string& content, const char* key, std::string& value);
+
+NATIVE_API_END
@@ -0,0 +1,55 @@
+#include "proc_utils.h"
+
+#include <fcntl.h>
+#include <cerrno>
+
+#include "sys_io.h"
+
+bool readFileFully(const char* path, std::string& out) {
+    out.clear();
+
+    int fd = sysio::openat(AT_FDCWD, path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    char buffer[4096];
+    for (;;) {
+        ssize_t n = sysio::read(fd, buffer, sizeof(buffer));
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            sysio::close(fd);
+            return false;
+        }
+        if (n == 0) break;
+        out.append(buffer, static_cast<size_t>(n));
+    }
+
+    sysio::close(fd);
+    return true;
+}
+
+bool readLinkString(const char* path, std::string& out) {
+    char buffer[512];
+    ssize_t n = sysio::readlinkat(AT_FDCWD, path, buffer, sizeof(buffer) - 1);
+    if (n <= 0) {
+        out.clear();
+        return false;
+    }
+    out.assign(buffer, static_cast<size_t>(n));
+    return true;
+}
+
+bool pathExists(const char* path, struct stat* st) {
+    struct stat local{};
+    return sysio::fstatat(AT_FDCWD, path, st != nullptr ? st : &local, 0) == 0;
+}
+
+uint64_t fnv1a64(const char* data, size_t len, uint64_t seed) {
+    uint64_t hash = seed;
+    for (size_t i = 0; i < len; i++) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
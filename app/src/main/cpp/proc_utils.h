@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#include "native_api.h"
+#include "sys_io.h"
+
+NATIVE_API_BEGIN
+
+/**
+ * 一次性读取整个文件
+ * procfs 文件的 st_size 为 0，只能循环 read 到 EOF
+ */
+bool readFileFully(const char* path, std::string& out);
+
+/**
+ * readlink 包装，自动补 '\0'
+ */
+bool readLinkString(const char* path, std::string& out);
+
+/**
+ * stat 包装，st 为空时只判断路径是否存在
+ */
+bool pathExists(const char* path, struct stat* st = nullptr);
+
+/**
+ * 用 getdents64 遍历已打开的目录，对每个非 "." / ".." 的目录项调用 fn(const sysio::Dirent64&)
+ * fn 返回 false 时提前结束；整个过程只使用栈上缓冲区，不分配堆内存
+ * 需要对目录项做 *at 系列调用时用这个版本，相对路径避免每次都从根解析
+ */
+template <typename Fn>
+void forEachDirEntry(int dirFd, Fn&& fn) {
+    alignas(8) char buffer[4096];
+    bool keepGoing = true;
+    while (keepGoing) {
+        long n = sysio::getdents64(dirFd, buffer, sizeof(buffer));
+        if (n <= 0) break;
+        for (long offset = 0; offset < n && keepGoing;) {
+            const auto* entry = reinterpret_cast<const sysio::Dirent64*>(buffer + offset);
+            offset += entry->d_reclen;
+            const char* name = entry->d_name;
+            if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'))) {
+                continue;
+            }
+            keepGoing = fn(*entry);
+        }
+    }
+}
+
+/**
+ * 按路径遍历目录，语义同上
+ */
+template <typename Fn>
+bool forEachDirEntry(const char* path, Fn&& fn) {
+    int fd = sysio::openat(AT_FDCWD, path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    forEachDirEntry(fd, fn);
+    sysio::close(fd);
+    return true;
+}
+
+/**
+ * 流式逐行读取文件，对每一行（不含换行符）调用 fn(const char* line, size_t len)
+ * fn 返回 false 时提前结束；只使用栈上缓冲区，超过缓冲区长度的行会被拆成多段
+ */
+template <typename Fn>
+bool forEachLine(const char* path, Fn&& fn) {
+    int fd = sysio::openat(AT_FDCWD, path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    char buffer[4096];
+    size_t used = 0;
+    bool keepGoing = true;
+    while (keepGoing) {
+        ssize_t n = sysio::read(fd, buffer + used, sizeof(buffer) - used);
+        if (n <= 0) break;
+        used += static_cast<size_t>(n);
+
+        size_t start = 0;
+        while (keepGoing) {
+            const void* newline = memchr(buffer + start, '\n', used - start);
+            if (newline == nullptr) break;
+            size_t end = static_cast<size_t>(static_cast<const char*>(newline) - buffer);
+            keepGoing = fn(static_cast<const char*>(buffer + start), end - start);
+            start = end + 1;
+        }
+        if (start == 0 && used == sizeof(buffer)) {
+            keepGoing = fn(static_cast<const char*>(buffer), used);
+            start = used;
+        }
+        memmove(buffer, buffer + start, used - start);
+        used -= start;
+    }
+    if (keepGoing && used > 0) {
+        fn(static_cast<const char*>(buffer), used);
+    }
+
+    sysio::close(fd);
+    return true;
+}
+
+/**
+ * FNV-1a 64 位哈希，用于条目指纹
+ */
+uint64_t fnv1a64(const char* data, size_t len, uint64_t seed = 0xcbf29ce484222325ULL);
+
+NATIVE_API_END
@@ -0,0 +1,177 @@
+#include "scan_context.h"
+
+#include <jni.h>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <android/log.h>
+
+#define LOG_TAG "ScanContext"
+#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+
+namespace {
+
+// 单条发现消息的长度上限
+constexpr size_t kMaxFindingLength = 256;
+
+thread_local ScanContext* t_boundContext = nullptr;
+
+} // namespace
+
+ScanArena::ScanArena(size_t chunkSize) : chunkSize_(chunkSize) {}
+
+void* ScanArena::allocate(size_t size, size_t align) {
+    for (;;) {
+        if (current_ < chunks_.size()) {
+            size_t offset = (used_ + align - 1) & ~(align - 1);
+            if (offset + size <= chunkSizes_[current_]) {
+                used_ = offset + size;
+                return chunks_[current_].get() + offset;
+            }
+            if (current_ + 1 < chunks_.size()) {
+                current_++;
+                used_ = 0;
+                continue;
+            }
+        }
+
+        // new char[] 已按基本类型的最大对齐分配，块内从偏移 0 开始即可
+        size_t capacity = size > chunkSize_ ? size : chunkSize_;
+        chunks_.emplace_back(new char[capacity]);
+        chunkSizes_.push_back(capacity);
+        current_ = chunks_.size() - 1;
+        used_ = 0;
+    }
+}
+
+const char* ScanArena::copy(const char* text, size_t len) {
+    auto* out = static_cast<char*>(allocate(len + 1, 1));
+    memcpy(out, text, len);
+    out[len] = '\0';
+    return out;
+}
+
+void ScanArena::reset() {
+    if (chunks_.size() > 1) {
+        chunks_.resize(1);
+        chunkSizes_.resize(1);
+    }
+    current_ = 0;
+    used_ = 0;
+}
+
+void ScanContext::addFinding(const char* source, const char* format, ...) {
+    char message[kMaxFindingLength];
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(message, sizeof(message), format, args);
+    va_end(args);
+    if (n < 0) return;
+
+    size_t len = static_cast<size_t>(n) < sizeof(message) ? static_cast<size_t>(n) : sizeof(message) - 1;
+    while (len > 0 && (message[len - 1] == '\n' || message[len - 1] == ' ')) len--;
+    findings_.push_back({source, arena_.copy(message, len)});
+}
+
+const char* ScanContext::latestFinding(const char* source) const {
+    for (auto it = findings_.rbegin(); it != findings_.rend(); ++it) {
+        if (strcmp(it->source, source) == 0) return it->message;
+    }
+    return nullptr;
+}
+
+void ScanContext::exportFindings(size_t from, CheckOutcome& outcome) const {
+    for (size_t i = from; i < findings_.size(); i++) {
+        outcome.findings.emplace_back(findings_[i].source, findings_[i].message);
+    }
+}
+
+void ScanContext::adoptFindings(const CheckOutcome& outcome) {
+    for (const auto& [source, message] : outcome.findings) {
+        findings_.push_back({source, arena_.copy(message.data(), message.size())});
+    }
+}
+
+void ScanContext::reset() {
+    snapshot_.reset();
+    findings_.clear();
+    arena_.reset();
+}
+
+ScanContext& currentScanContext() {
+    if (t_boundContext != nullptr) {
+        return *t_boundContext;
+    }
+    thread_local ScanContext defaultContext;
+    return defaultContext;
+}
+
+ScanContextScope::ScanContextScope(ScanContext& context) : previous_(t_boundContext) {
+    t_boundContext = &context;
+}
+
+ScanContextScope::~ScanContextScope() {
+    t_boundContext = previous_;
+}
+
+ProcSnapshot& currentSnapshot() {
+    return currentScanContext().snapshot();
+}
+
+/**
+ * 开始新一轮扫描，丢弃当前线程上一轮的快照和发现
+ */
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_grtsinry43_environmentdetector_security_NativeSecurityDetector_nativeBeginScan(
+        JNIEnv* env,
+        jclass clazz) {
+    currentScanContext().reset();
+}
+
+/**
+ * 当前线程本轮扫描中指定来源的最近一条发现，没有时返回 null
+ */
+extern "C"
+JNIEXPORT jstring JNICALL
+Java_com_grtsinry43_environmentdetector_security_NativeSecurityDetector_nativeGetScanFinding(
+        JNIEnv* env,
+        jclass clazz,
+        jstring source) {
+
+    const char* sourceChars = env->GetStringUTFChars(source, nullptr);
+    if (sourceChars == nullptr) {
+        return nullptr;
+    }
+    const char* message = currentScanContext().latestFinding(sourceChars);
+    env->ReleaseStringUTFChars(source, sourceChars);
+    return message != nullptr ? env->NewStringUTF(message) : nullptr;
+}
+
+/**
+ * 结束当前线程的扫描，导出本轮记录的发现（"来源: 消息"）并重置上下文
+ */
+extern "C"
+JNIEXPORT jobjectArray JNICALL
+Java_com_grtsinry43_environmentdetector_security_NativeSecurityDetector_nativeEndScan(
+        JNIEnv* env,
+        jclass clazz) {
+
+    ScanContext& context = currentScanContext();
+    const std::vector<Finding>& findings = context.findings();
+
+    jclass stringClass = env->FindClass("java/lang/String");
+    jobjectArray result = env->NewObjectArray(static_cast<jsize>(findings.size()), stringClass, nullptr);
+    for (size_t i = 0; result != nullptr && i < findings.size(); i++) {
+        char line[kMaxFindingLength + 64];
+        snprintf(line, sizeof(line), "%s: %s", findings[i].source, findings[i].message);
+        jstring text = env->NewStringUTF(line);
+        env->SetObjectArrayElement(result, static_cast<jsize>(i), text);
+        env->DeleteLocalRef(text);
+    }
+    env->DeleteLocalRef(stringClass);
+
+    LOGD("Scan ended with %zu findings", findings.size());
+    context.reset();
+    return result;
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "native_api.h"
+#include "proc_snapshot.h"
+
+NATIVE_API_BEGIN
+
+/**
+ * 扫描期间的临时分配：按块递增分配，扫描结束时整体回收
+ * 保留第一块供下次扫描复用，稳态下不再向堆申请内存
+ */
+class ScanArena {
+public:
+    explicit ScanArena(size_t chunkSize = 16 * 1024);
+
+    ScanArena(const ScanArena&) = delete;
+    ScanArena& operator=(const ScanArena&) = delete;
+
+    void* allocate(size_t size, size_t align = alignof(std::max_align_t));
+
+    /**
+     * 复制一个字符串到 arena，返回以 '\0' 结尾的副本
+     */
+    const char* copy(const char* text, size_t len);
+
+    void reset();
+
+private:
+    size_t chunkSize_;
+    std::vector<std::unique_ptr<char[]>> chunks_;
+    std::vector<size_t> chunkSizes_;
+    size_t current_ = 0;
+    size_t used_ = 0;
+};
+
+/**
+ * 一条检测发现，字符串都在所属扫描上下文的 arena 中
+ */
+struct Finding {
+    const char* source;
+    const char* message;
+};
+
+/**
+ * 一次检测的判定及其间记录的发现（自有副本，不依赖任何上下文的 arena）
+ * 用于把检测结果交给没有亲自执行检测的线程，例如单飞中等待的调用者
+ */
+struct CheckOutcome {
+    bool detected = false;
+    std::vector<std::pair<const char*, std::string>> findings;
+};
+
+/**
+ * 一次扫描的全部可变状态：procfs 快照、读文件用的缓冲区、arena 和检测发现
+ * 每个线程通过 currentScanContext() 拿到自己的上下文，不同线程的扫描互不干扰
+ */
+class ScanContext {
+public:
+    ScanContext() = default;
+
+    ScanContext(const ScanContext&) = delete;
+    ScanContext& operator=(const ScanContext&) = delete;
+
+    ProcSnapshot& snapshot() { return snapshot_; }
+
+    ScanArena& arena() { return arena_; }
+
+    /**
+     * 可复用的读文件缓冲区，内容只在下一次使用前有效
+     */
+    std::string& scratch() { return scratch_; }
+
+    /**
+     * 记录一条发现，消息按 printf 格式化后存入 arena
+     */
+    void addFinding(const char* source, const char* format, ...) __attribute__((format(printf, 3, 4)));
+
+    const std::vector<Finding>& findings() const { return findings_; }
+
+    /**
+     * 指定来源的最近一条发现，没有时返回 nullptr
+     */
+    const char* latestFinding(const char* source) const;
+
+    /**
+     * 把第 from 条起的发现复制到 outcome
+     */
+    void exportFindings(size_t from, CheckOutcome& outcome) const;
+
+    /**
+     * 把别的线程导出的发现追加到本上下文
+     */
+    void adoptFindings(const CheckOutcome& outcome);
+
+    /**
+     * 开始新的扫描：丢弃快照、发现，回收 arena
+     */
+    void reset();
+
+private:
+    ProcSnapshot snapshot_;
+    ScanArena arena_;
+    std::string scratch_;
+    std::vector<Finding> findings_;
+};
+
+/**
+ * 当前线程的扫描上下文
+ * 没有显式绑定时使用线程私有的默认上下文，随线程退出释放
+ */
+ScanContext& currentScanContext();
+
+/**
+ * 在作用域内把指定上下文绑定到当前线程，供 native 线程持有自己的上下文；析构时恢复之前的绑定
+ */
+class ScanContextScope {
+public:
+    explicit ScanContextScope(ScanContext& context);
+    ~ScanContextScope();
+
+    ScanContextScope(const ScanContextScope&) = delete;
+    ScanContextScope& operator=(const ScanContextScope&) = delete;
+
+private:
+    ScanContext* previous_;
+};
+
+NATIVE_API_END
@@ -1,16 +1,22 @@
 #include <jni.h>
+#include <cstdlib>
 #include <string>
-#include <fstream>
-#include <sstream>
 #include <unistd.h>
 #include <sys/ptrace.h>
 #include <sys/stat.h>
-#include <dirent.h>
 #include <android/log.h>
 #include <dlfcn.h>
 #include <link.h>
 #include <sys/system_properties.h>
 
+#include "event_log.h"
+#include "proc_snapshot.h"
+#include "proc_utils.h"
+#include "scan_context.h"
+#include "single_flight.h"
+#include "sys_io.h"
+#include "timing_probe.h"
+
 #define LOG_TAG "SecurityNative"
 #define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
 #define LOGW(...) __android_log_print(ANDROID_LOG_WARN, LOG_TAG, __VA_ARGS__)
@@ -19,24 +25,30 @@
 // 外部声明反 Hook 验证函数
 extern bool verifyNativeCall(JNIEnv* env);
 
+// 外部声明单函数断点检查
+extern bool checkFunctionBreakpoints(const void* fn);
+
+// 外部声明环境变量扫描
+extern bool checkEnvironment();
+
 /**
  * 反调试：检测 TracerPid
  */
 bool checkTracerPid() {
-    std::ifstream statusFile("/proc/self/status");
-    if (!statusFile.is_open()) {
+    // 调试器可能随时 attach，这里读取实时内容而不是扫描快照
+    ScanContext& context = currentScanContext();
+    std::string& status = context.scratch();
+    if (!readFileFully("/proc/self/status", status)) {
         return false;
     }
 
-    std::string line;
-    while (std::getline(statusFile, line)) {
-        if (line.find("TracerPid:") == 0) {
-            int tracerPid = std::stoi(line.substr(10));
-            if (tracerPid != 0) {
-                LOGW("TracerPid detected: %d", tracerPid);
-                return true;
-            }
-            break;
+    std::string value;
+    if (findStatusField(status, "TracerPid", value)) {
+        int tracerPid = atoi(value.c_str());
+        if (tracerPid != 0) {
+            EVLOG_W(TracerPid, tracerPid);
+            context.addFinding("debugger", "TracerPid %d", tracerPid);
+            return true;
         }
     }
     return false;
@@ -69,10 +81,12 @@ bool checkPtraceAttach() {
  * 检测 Frida 特征：检查特定端口（更全面）
  */
 bool checkFridaPort() {
-    std::ifstream tcp4File("/proc/net/tcp");
-    std::ifstream tcp6File("/proc/net/tcp6");
+    std::string tcp4Content;
+    std::string tcp6Content;
+    bool tcp4Ok = readFileFully("/proc/net/tcp", tcp4Content);
+    bool tcp6Ok = readFileFully("/proc/net/tcp6", tcp6Content);
 
-    if (!tcp4File.is_open() && !tcp6File.is_open()) {
+    if (!tcp4Ok && !tcp6Ok) {
         return false;
     }
 
@@ -80,25 +94,19 @@ bool checkFridaPort() {
     // 27042 = 0x6992, 27043 = 0x6993, 27045 = 0x6995
     const char* fridaPorts[] = {"697A", "697B", "697C", "697D", "6992", "6993", "6995"};
 
-    std::string line;
-
     // 检查 IPv4
-    while (std::getline(tcp4File, line)) {
-        for (const char* port : fridaPorts) {
-            if (line.find(port) != std::string::npos) {
-                LOGW("Frida port detected in tcp: %s", port);
-                return true;
-            }
+    for (const char* port : fridaPorts) {
+        if (tcp4Content.find(port) != std::string::npos) {
+            LOGW("Frida port detected in tcp: %s", port);
+            return true;
         }
     }
 
     // 检查 IPv6
-    while (std::getline(tcp6File, line)) {
-        for (const char* port : fridaPorts) {
-            if (line.find(port) != std::string::npos) {
-                LOGW("Frida port detected in tcp6: %s", port);
-                return true;
-            }
+    for (const char* port : fridaPorts) {
+        if (tcp6Content.find(port) != std::string::npos) {
+            LOGW("Frida port detected in tcp6: %s", port);
+            return true;
         }
     }
 
@@ -110,36 +118,28 @@ bool checkFridaPort() {
  * Frida 会创建特定名称的线程
  */
 bool checkFridaThreads() {
-    DIR* taskDir = opendir("/proc/self/task");
-    if (taskDir == nullptr) {
-        return false;
-    }
-
-    struct dirent* entry;
-    while ((entry = readdir(taskDir)) != nullptr) {
-        if (entry->d_name[0] == '.') continue;
+    bool detected = false;
+    std::string threadName;
 
+    forEachDirEntry("/proc/self/task", [&](const sysio::Dirent64& entry) {
         char commPath[256];
-        snprintf(commPath, sizeof(commPath), "/proc/self/task/%s/comm", entry->d_name);
-
-        std::ifstream commFile(commPath);
-        if (commFile.is_open()) {
-            std::string threadName;
-            std::getline(commFile, threadName);
+        snprintf(commPath, sizeof(commPath), "/proc/self/task/%s/comm", entry.d_name);
 
+        if (readFileFully(commPath, threadName)) {
             // Frida 的典型线程名
             if (threadName.find("gmain") != std::string::npos ||
                 threadName.find("gum-js-loop") != std::string::npos ||
                 threadName.find("gdbus") != std::string::npos ||
                 threadName.find("pool-frida") != std::string::npos) {
-                LOGW("Frida thread detected: %s", threadName.c_str());
-                closedir(taskDir);
-                return true;
+                EVLOG_W(FridaThread, eventlog::intern(std::string_view(threadName).substr(0, threadName.find('\n'))));
+                currentScanContext().addFinding("frida", "thread %s", threadName.c_str());
+                detected = true;
+                return false;
             }
         }
-    }
-    closedir(taskDir);
-    return false;
+        return true;
+    });
+    return detected;
 }
 
 /**
@@ -153,8 +153,7 @@ bool checkFridaFiles() {
     };
 
     for (const char* file : fridaFiles) {
-        struct stat fileStat{};
-        if (stat(file, &fileStat) == 0) {
+        if (pathExists(file)) {
             LOGW("Frida file detected: %s", file);
             return true;
         }
@@ -167,17 +166,16 @@ bool checkFridaFiles() {
  * 通过扫描内存映射查找 Frida 的典型符号
  */
 bool checkFridaInMemory() {
-    std::ifstream mapsFile("/proc/self/maps");
-    if (!mapsFile.is_open()) {
-        return false;
-    }
+    const MapsSnapshot& maps = currentSnapshot().maps();
 
-    std::string line;
-    while (std::getline(mapsFile, line)) {
+    // 驻留后的路径各不相同，每个文件只需要检查一次
+    const PathInterner& paths = maps.paths();
+    for (uint32_t id = 1; id < paths.size(); id++) {
+        const std::string& path = paths.path(id);
         // 检查是否包含 Frida 相关的库或路径
-        if (line.find("frida") != std::string::npos ||
-            line.find("linjector") != std::string::npos) {
-            LOGW("Frida signature in memory maps: %s", line.c_str());
+        if (path.find("frida") != std::string::npos ||
+            path.find("linjector") != std::string::npos) {
+            EVLOG_W(FridaMapping, eventlog::intern(path));
             return true;
         }
     }
@@ -237,7 +235,7 @@ bool checkSuBinary() {
 
     for (const char* path : suPaths) {
         struct stat fileStat{};
-        if (stat(path, &fileStat) == 0) {
+        if (pathExists(path, &fileStat)) {
             // 检查是否为可执行文件
             if (fileStat.st_mode & S_IXUSR) {
                 LOGW("Su binary found and executable: %s", path);
@@ -289,7 +287,7 @@ bool checkDangerousPermissions() {
     };
 
     for (const char* path : paths) {
-        if (access(path, W_OK) == 0) {
+        if (sysio::faccessat(AT_FDCWD, path, W_OK) == 0) {
             LOGW("Write access to system directory: %s", path);
             return true;
         }
@@ -301,10 +299,7 @@ bool checkDangerousPermissions() {
  * 检测 Hook：扫描已加载的库
  */
 bool checkLoadedLibraries() {
-    std::ifstream mapsFile("/proc/self/maps");
-    if (!mapsFile.is_open()) {
-        return false;
-    }
+    const PathInterner& paths = currentSnapshot().maps().paths();
 
     const char* suspiciousLibs[] = {
             "frida",
@@ -314,12 +309,12 @@ bool checkLoadedLibraries() {
             "lsposed"
     };
 
-    std::string line;
-    while (std::getline(mapsFile, line)) {
+    for (uint32_t id = 1; id < paths.size(); id++) {
+        const std::string& path = paths.path(id);
         for (const char* lib : suspiciousLibs) {
-            if (line.find(lib) != std::string::npos) {
-                LOGW("Suspicious library in memory: %s", lib);
-                LOGW("Maps line: %s", line.c_str());
+            if (path.find(lib) != std::string::npos) {
+                EVLOG_W(SuspiciousLibrary, eventlog::intern(lib), eventlog::intern(path));
+                currentScanContext().addFinding("hook", "library %s", path.c_str());
                 return true;
             }
         }
@@ -346,21 +341,13 @@ bool detectFrida() {
  * 检测模拟器：CPU 特征
  */
 bool checkEmulatorCpu() {
-    std::ifstream cpuinfoFile("/proc/cpuinfo");
-    if (!cpuinfoFile.is_open()) {
+    std::string content;
+    if (!readFileFully("/proc/cpuinfo", content)) {
         return false;
     }
 
-    std::string content((std::istreambuf_iterator<char>(cpuinfoFile)),
-                        std::istreambuf_iterator<char>());
-
-    // 检测 x86 架构（大多数真实设备是 ARM）
-    if (content.find("Intel") != std::string::npos ||
-        content.find("AMD") != std::string::npos ||
-        content.find("GenuineIntel") != std::string::npos) {
-        LOGW("x86 CPU detected");
-        return true;
-    }
+    // 不再仅凭 Intel/AMD 判定：x86 Chromebook 是真实设备，
+    // ARM 上的虚拟化也不会出现这些字样，交给 checkTimingAnomaly 判断
 
     // 检测模拟器特征
     if (content.find("goldfish") != std::string::npos ||
@@ -386,8 +373,7 @@ bool checkQemuFiles() {
     };
 
     for (const char* file : qemuFiles) {
-        struct stat fileStat{};
-        if (stat(file, &fileStat) == 0) {
+        if (pathExists(file)) {
             LOGW("QEMU file detected: %s", file);
             return true;
         }
@@ -399,13 +385,13 @@ bool checkQemuFiles() {
  * 检测内存中的可疑字符串
  */
 bool checkSuspiciousStrings() {
-    std::ifstream cmdlineFile("/proc/self/cmdline");
-    if (!cmdlineFile.is_open()) {
+    ProcSnapshot& snapshot = currentSnapshot();
+    if (!snapshot.available(ProcFile::Cmdline)) {
         return false;
     }
 
-    std::string cmdline;
-    std::getline(cmdlineFile, cmdline, '\0');
+    // 只取第一个参数（进程名）
+    std::string cmdline(snapshot.get(ProcFile::Cmdline).c_str());
 
     const char* suspiciousStrs[] = {
             "frida",
@@ -425,71 +411,61 @@ bool checkSuspiciousStrings() {
     return false;
 }
 
-/**
- * 检测 LD_PRELOAD
- */
-bool checkLdPreload() {
-    char* ldPreload = getenv("LD_PRELOAD");
-    if (ldPreload != nullptr && strlen(ldPreload) > 0) {
-        LOGW("LD_PRELOAD detected: %s", ldPreload);
-        return true;
-    }
-    return false;
-}
+// ============ JNI 导出函数 ============
+
+// 并发的 JNI 调用合并为一次检测并共享结果；这里不设新鲜度窗口，结果复用由 Java 层按扫描配置决定
+static SingleFlight<CheckOutcome> g_rootFlight;
+static SingleFlight<CheckOutcome> g_hookFlight;
+static SingleFlight<CheckOutcome> g_debuggerFlight;
+static SingleFlight<CheckOutcome> g_emulatorFlight;
 
 /**
- * 检测异常的文件描述符
- * 调整阈值以减少误报
+ * 单飞执行一组检测：执行者的发现已经记在自己的上下文中，
+ * 等待者拿到判定的同时把执行者的发现复制进自己的上下文，nativeEndScan 能导出同样的内容
  */
-bool checkAbnormalFd() {
-    DIR* dir = opendir("/proc/self/fd");
-    if (dir == nullptr) {
-        return false;
-    }
-
-    int fdCount = 0;
-    struct dirent* entry;
-    while ((entry = readdir(dir)) != nullptr) {
-        if (entry->d_name[0] != '.') {
-            fdCount++;
-        }
-    }
-    closedir(dir);
-
-    // 提高阈值到 200，减少误报
-    // 现代应用可能使用很多 fd（网络、文件、线程等）
-    if (fdCount > 200) {
-        LOGW("Abnormal FD count: %d", fdCount);
-        return true;
-    }
-
-    return false;
+template <typename Fn>
+static bool runShared(SingleFlight<CheckOutcome>& flight, Fn&& check) {
+    ScanContext& context = currentScanContext();
+    bool executed = false;
+    CheckOutcome outcome = flight.run([&] {
+        executed = true;
+        size_t before = context.findings().size();
+        CheckOutcome result;
+        result.detected = check();
+        context.exportFindings(before, result);
+        return result;
+    });
+    if (!executed) {
+        context.adoptFindings(outcome);
+    }
+    return outcome.detected;
 }
 
-// ============ JNI 导出函数 ============
-
 extern "C"
 JNIEXPORT jboolean JNICALL
 Java_com_grtsinry43_environmentdetector_security_NativeSecurityDetector_nativeCheckRoot(
         JNIEnv* env,
         jclass clazz) {
 
-    LOGD("Native Root check started");
+    EVLOG_D(CheckStarted, CheckId::Root);
 
     // 验证调用完整性 - 防止直接调用 .so
     if (!verifyNativeCall(env)) {
-        LOGE("Call verification failed - possible SO hijacking");
+        EVLOG_W(CallVerificationFailed);
         return true; // 检测到异常，返回 true
     }
 
-    bool isRooted = false;
+    bool isRooted = runShared(g_rootFlight, [] {
+        bool rooted = false;
 
-    // 综合多个检测点
-    if (checkSuBinary()) isRooted = true;
-    if (checkRootProperties()) isRooted = true;
-    if (checkDangerousPermissions()) isRooted = true;
+        // 综合多个检测点
+        if (checkSuBinary()) rooted = true;
+        if (checkRootProperties()) rooted = true;
+        if (checkDangerousPermissions()) rooted = true;
+        return rooted;
+    });
 
-    LOGD("Native Root check result: %s", isRooted ? "ROOTED" : "CLEAN");
+    EVLOG_I(CheckResult, CheckId::Root, isRooted);
     return isRooted;
 }
 
@@ -499,16 +475,18 @@ Java_com_grtsinry43_environmentdetector_security_NativeSecurityDetector_nativeCh
         JNIEnv* env,
         jclass clazz) {
 
-    LOGD("Native Hook check started");
+    EVLOG_D(CheckStarted, CheckId::Hook);
 
-    bool isHooked = false;
+    bool isHooked = runShared(g_hookFlight, [] {
+        bool hooked = false;
+        if (checkLoadedLibraries()) hooked = true;
+        if (detectFrida()) hooked = true;
+        if (checkSuspiciousStrings()) hooked = true;
+        if (checkEnvironment()) hooked = true;
+        return hooked;
+    });
 
-    if (checkLoadedLibraries()) isHooked = true;
-    if (detectFrida()) isHooked = true;
-    if (checkSuspiciousStrings()) isHooked = true;
-    if (checkLdPreload()) isHooked = true;
-
-    LOGD("Native Hook check result: %s", isHooked ? "HOOKED" : "CLEAN");
+    EVLOG_I(CheckResult, CheckId::Hook, isHooked);
     return isHooked;
 }
 
@@ -518,33 +496,74 @@ Java_com_grtsinry43_environmentdetector_security_NativeSecurityDetector_nativeCh
         JNIEnv* env,
         jclass clazz) {
 
-    LOGD("Native Debugger check started");
+    EVLOG_D(CheckStarted, CheckId::Debugger);
 
-    bool isDebugging = false;
+    bool isDebugging = runShared(g_debuggerFlight, [] {
+        bool debugging = false;
 
-    // 只检查 TracerPid，移除 ptrace 检测以减少误报
-    if (checkTracerPid()) isDebugging = true;
+        // 只检查 TracerPid，移除 ptrace 检测以减少误报
+        if (checkTracerPid()) debugging = true;
 
-    // checkAbnormalFd 也可能误报，只作为辅助判断
-    // if (checkAbnormalFd()) isDebugging = true;
+        // 隐藏了 TracerPid 的调试器仍要在入口处下断点，只比对这几个热点函数的开头
+        const void* const hotFunctions[] = {
+                reinterpret_cast<const void*>(&checkTracerPid),
+                reinterpret_cast<const void*>(&Java_com_grtsinry43_environmentdetector_security_NativeSecurityDetector_nativeCheckRoot),
+                reinterpret_cast<const void*>(&Java_com_grtsinry43_environmentdetector_security_NativeSecurityDetector_nativeCheckHook),
+                reinterpret_cast<const void*>(&Java_com_grtsinry43_environmentdetector_security_NativeSecurityDetector_nativeCheckDebugger)
+        };
+        for (const void* fn : hotFunctions) {
+            if (checkFunctionBreakpoints(fn)) debugging = true;
+        }
+        return debugging;
+    });
 
-    LOGD("Native Debugger check result: %s", isDebugging ? "DEBUGGING" : "CLEAN");
+    EVLOG_I(CheckResult, CheckId::Debugger, isDebugging);
     return isDebugging;
 }
 
+/**
+ * 把模拟器检测时测得的时间剖面记为发现（格式见 timingProfileValues），
+ * Java 层在报告中直接取用，不再重新跑一遍微基准
+ */
+static void recordTimingProfile(const TimingProfile& profile) {
+    int64_t values[kTimingProfileValues];
+    timingProfileValues(profile, values);
+    currentScanContext().addFinding("timing", "%lld,%lld,%lld,%lld,%lld,%lld",
+                                    static_cast<long long>(values[0]), static_cast<long long>(values[1]),
+                                    static_cast<long long>(values[2]), static_cast<long long>(values[3]),
+                                    static_cast<long long>(values[4]), static_cast<long long>(values[5]));
+}
+
 extern "C"
 JNIEXPORT jboolean JNICALL
 Java_com_grtsinry43_environmentdetector_security_NativeSecurityDetector_nativeCheckEmulator(
         JNIEnv* env,
         jclass clazz) {
 
-    LOGD("Native Emulator check started");
+    EVLOG_D(CheckStarted, CheckId::Emulator);
 
-    bool isEmulator = false;
+    bool isEmulator = runShared(g_emulatorFlight, [] {
+        bool emulator = false;
+        if (checkEmulatorCpu()) emulator = true;
+        if (checkQemuFiles()) emulator = true;
+        TimingProfile timing{};
+        if (checkTimingAnomaly(timing)) emulator = true;
+        recordTimingProfile(timing);
+        return emulator;
+    });
 
-    if (checkEmulatorCpu()) isEmulator = true;
-    if (checkQemuFiles()) isEmulator = true;
-
-    LOGD("Native Emulator check result: %s", isEmulator ? "EMULATOR" : "DEVICE");
+    EVLOG_I(CheckResult, CheckId::Emulator, isEmulator);
     return isEmulator;
 }
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_grtsinry43_environmentdetector_security_NativeSecurityDetector_nativeSetRawSyscallIo(
+        JNIEnv* env,
+        jclass clazz,
+        jboolean enabled) {
+
+    // 基准测试用：在原始系统调用和 libc 两条 I/O 路径之间切换
+    sysio::setBackend(enabled ? sysio::Backend::Raw : sysio::Backend::Libc);
+    LOGD("Native I/O backend: %s", enabled ? "raw syscalls" : "libc");
+}
@@ -0,0 +1,165 @@
+#include <jni.h>
+#include <csignal>
+#include <string>
+#include <android/log.h>
+
+#include "event_log.h"
+#include "module_index.h"
+#include "proc_snapshot.h"
+#include "proc_utils.h"
+#include "sys_io.h"
+
+#define LOG_TAG "SignalAudit"
+#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+
+namespace {
+
+// 内核支持的信号编号 1..64
+constexpr int kMaxSignal = 64;
+
+/**
+ * 一个信号在两个视图中的处理函数
+ * chain：libc sigaction 返回的（libsigchain 接管的信号返回链上登记的处理函数）
+ * kernel：rt_sigaction 直接读到的内核实际使用的处理函数
+ */
+struct SignalHandlers {
+    uintptr_t chain;
+    uintptr_t kernel;
+};
+
+struct SignalBaseline {
+    bool captured = false;
+    SignalHandlers handlers[kMaxSignal + 1];
+};
+
+SignalBaseline g_signalBaseline;
+
+uintptr_t chainHandlerOf(int sig) {
+    struct sigaction action{};
+    if (sigaction(sig, nullptr, &action) != 0) {
+        return 0;
+    }
+    if ((action.sa_flags & SA_SIGINFO) != 0) {
+        return reinterpret_cast<uintptr_t>(action.sa_sigaction);
+    }
+    return reinterpret_cast<uintptr_t>(action.sa_handler);
+}
+
+uintptr_t kernelHandlerOf(int sig) {
+    sysio::KernelSigaction action{};
+    if (sysio::rtSigaction(sig, &action) != 0) {
+        return 0;
+    }
+    return action.handler;
+}
+
+void readHandlers(SignalHandlers (&handlers)[kMaxSignal + 1]) {
+    for (int sig = 1; sig <= kMaxSignal; sig++) {
+        handlers[sig] = {chainHandlerOf(sig), kernelHandlerOf(sig)};
+    }
+}
+
+inline bool isDefaultOrIgnored(uintptr_t handler) {
+    return handler == reinterpret_cast<uintptr_t>(SIG_DFL) ||
+           handler == reinterpret_cast<uintptr_t>(SIG_IGN);
+}
+
+/**
+ * 调试器和 Hook 框架实现断点、跳板所依赖的信号
+ */
+inline bool isTrapSignal(int sig) {
+    return sig == SIGTRAP || sig == SIGILL || sig == SIGBUS || sig == SIGSEGV || sig == SIGFPE;
+}
+
+/**
+ * 处理函数是否可疑
+ * 不在任何已知模块内（匿名内存、可写目录下的文件、未映射）的一律可疑；
+ * 陷阱类信号在加载后被换掉时，只有新处理函数落在应用和系统镜像之外才可疑：
+ * 应用自带的崩溃收集库（Crashpad、Bugly 等）初始化时会接管 SIGSEGV/SIGBUS，属于正常情况
+ */
+bool isSuspiciousHandler(const ModuleIndex& index, int sig, uintptr_t handler, uintptr_t baseline) {
+    if (isDefaultOrIgnored(handler)) {
+        return false;
+    }
+
+    CodeOrigin origin = index.classify(handler);
+    if (origin == CodeOrigin::Unmapped || origin == CodeOrigin::Anonymous || origin == CodeOrigin::Other) {
+        return true;
+    }
+    if (g_signalBaseline.captured && handler != baseline && isTrapSignal(sig)) {
+        return origin != CodeOrigin::Runtime && origin != CodeOrigin::SystemLibrary &&
+               origin != CodeOrigin::AppLibrary && origin != CodeOrigin::CompiledDex;
+    }
+    return false;
+}
+
+int countSuspiciousHandlers(const ModuleIndex& index, const SignalHandlers (&handlers)[kMaxSignal + 1],
+                            bool report) {
+    int suspicious = 0;
+    for (int sig = 1; sig <= kMaxSignal; sig++) {
+        const SignalHandlers& current = handlers[sig];
+        const SignalHandlers& baseline = g_signalBaseline.handlers[sig];
+
+        const uintptr_t views[] = {current.chain, current.kernel};
+        const uintptr_t baselines[] = {baseline.chain, baseline.kernel};
+        for (int view = 0; view < 2; view++) {
+            if (!isSuspiciousHandler(index, sig, views[view], baselines[view])) continue;
+
+            suspicious++;
+            if (report) {
+                EVLOG_W(SuspiciousSignalHandler, sig, eventlog::intern(index.pathOf(views[view])),
+                        eventlog::intern(ModuleIndex::originName(index.classify(views[view]))));
+            }
+        }
+    }
+    return suspicious;
+}
+
+} // namespace
+
+/**
+ * 记录加载时的信号处理函数基线，由库构造函数调用（见 early_stage.cpp）
+ */
+void captureSignalBaseline() {
+    readHandlers(g_signalBaseline.handlers);
+    g_signalBaseline.captured = true;
+}
+
+/**
+ * 检测 Hook/调试器：所有信号的处理函数审计
+ * 一轮 128 次系统调用读取 libsigchain 和内核两个视图，
+ * 按地址所属模块判断处理函数是否来自注入的代码
+ */
+bool checkSignalHandlers() {
+    SignalHandlers handlers[kMaxSignal + 1] = {};
+    readHandlers(handlers);
+
+    ModuleIndex index(currentSnapshot().maps());
+    if (countSuspiciousHandlers(index, handlers, false) == 0) {
+        return false;
+    }
+
+    // 处理函数可能位于快照之后才加载的库中，用新读取的 maps 再确认
+    std::string content;
+    if (!readFileFully("/proc/self/maps", content)) {
+        return false;
+    }
+    MapsSnapshot fresh;
+    fresh.parse(content);
+    ModuleIndex freshIndex(fresh);
+    return countSuspiciousHandlers(freshIndex, handlers, true) > 0;
+}
+
+extern "C"
+JNIEXPORT jboolean JNICALL
+Java_com_grtsinry43_environmentdetector_security_NativeSecurityDetector_nativeCheckSignalHandlers(
+        JNIEnv* env,
+        jclass clazz) {
+
+    EVLOG_D(CheckStarted, CheckId::SignalHandlers);
+
+    bool suspicious = checkSignalHandlers();
+
+    EVLOG_I(CheckResult, CheckId::SignalHandlers, suspicious);
+    return suspicious;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+
+#include "timing_probe.h"
+
+/**
+ * 单飞（single-flight）：同一时刻只执行一次计算，并发的调用者等待并共享这次的结果
+ * freshnessNs > 0 时，上次结果在该时间窗内直接复用，不再重新计算
+ * 无论多少线程同时调用，实际执行次数只取决于调用的时间分布，与调用者数量无关
+ */
+template <typename T>
+class SingleFlight {
+public:
+    explicit SingleFlight(int64_t freshnessNs = 0) : freshnessNs_(freshnessNs) {}
+
+    SingleFlight(const SingleFlight&) = delete;
+    SingleFlight& operator=(const SingleFlight&) = delete;
+
+    /**
+     * 没有进行中的计算时由当前线程执行 fn，否则等待进行中的那次完成并返回其结果
+     * fn 在锁外执行；fn 抛出异常时，执行者和这一轮的等待者都收到同一个异常，之后的调用重新计算
+     */
+    template <typename Fn>
+    T run(Fn&& fn) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (hasResult_ && freshnessNs_ > 0 && monotonicNowNs() - completedAtNs_ < freshnessNs_) {
+            return result_;
+        }
+        if (running_) {
+            uint64_t generation = generation_;
+            done_.wait(lock, [this, generation] { return generation_ != generation; });
+            if (error_) std::rethrow_exception(error_);
+            return result_;
+        }
+
+        running_ = true;
+        lock.unlock();
+
+        // 无论 fn 正常返回还是抛出异常都结束这一轮并唤醒等待者，否则之后的调用者会永远阻塞
+        std::exception_ptr error;
+        Completion completion{*this, lock, error};
+        T result;
+        try {
+            result = fn();
+        } catch (...) {
+            error = std::current_exception();
+            throw;
+        }
+
+        lock.lock();
+        result_ = result;
+        hasResult_ = true;
+        completedAtNs_ = monotonicNowNs();
+        return result;
+    }
+
+private:
+    /**
+     * 作用域守卫：复位运行状态、记录本轮异常并唤醒等待者，析构时持有锁
+     */
+    struct Completion {
+        SingleFlight& flight;
+        std::unique_lock<std::mutex>& lock;
+        const std::exception_ptr& error;
+
+        ~Completion() {
+            if (!lock.owns_lock()) lock.lock();
+            flight.error_ = error;
+            flight.generation_++;
+            flight.running_ = false;
+            flight.done_.notify_all();
+        }
+    };
+
+    const int64_t freshnessNs_;
+    std::mutex mutex_;
+    std::condition_variable done_;
+    bool running_ = false;
+    bool hasResult_ = false;
+    uint64_t generation_ = 0;
+    int64_t completedAtNs_ = 0;
+    std::exception_ptr error_;
+    T result_{};
+};
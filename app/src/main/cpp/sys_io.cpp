@@ -0,0 +1,277 @@
+#include "sys_io.h"
+
+#include <atomic>
+#include <cerrno>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#if defined(SYSIO_REPLAY)
+#include <climits>
+#include <cstdio>
+#endif
+
+namespace sysio {
+
+namespace {
+
+std::atomic<Backend> g_backend{Backend::Raw};
+
+/**
+ * 各 ABI 的内联系统调用
+ * 返回内核原始结果：成功为非负数，失败为 -errno
+ */
+#if defined(__aarch64__)
+
+long rawSyscall(long nr, long a0 = 0, long a1 = 0, long a2 = 0, long a3 = 0, long a4 = 0, long a5 = 0) {
+    register long x8 __asm__("x8") = nr;
+    register long x0 __asm__("x0") = a0;
+    register long x1 __asm__("x1") = a1;
+    register long x2 __asm__("x2") = a2;
+    register long x3 __asm__("x3") = a3;
+    register long x4 __asm__("x4") = a4;
+    register long x5 __asm__("x5") = a5;
+    __asm__ volatile("svc #0"
+            : "+r"(x0)
+            : "r"(x8), "r"(x1), "r"(x2), "r"(x3), "r"(x4), "r"(x5)
+            : "memory", "cc");
+    return x0;
+}
+
+#elif defined(__arm__)
+
+long rawSyscall(long nr, long a0 = 0, long a1 = 0, long a2 = 0, long a3 = 0, long a4 = 0, long a5 = 0) {
+    register long r0 __asm__("r0") = a0;
+    register long r1 __asm__("r1") = a1;
+    register long r2 __asm__("r2") = a2;
+    register long r3 __asm__("r3") = a3;
+    register long r4 __asm__("r4") = a4;
+    register long r5 __asm__("r5") = a5;
+    register long r6 __asm__("r6") = nr;
+    // Thumb 模式下 r7 是帧指针，不能直接作为约束，手动保存后再放入调用号
+    __asm__ volatile("push {r7}\n"
+                     "mov r7, r6\n"
+                     "svc #0\n"
+                     "pop {r7}"
+            : "+r"(r0)
+            : "r"(r1), "r"(r2), "r"(r3), "r"(r4), "r"(r5), "r"(r6)
+            : "memory", "cc");
+    return r0;
+}
+
+#elif defined(__x86_64__)
+
+long rawSyscall(long nr, long a0 = 0, long a1 = 0, long a2 = 0, long a3 = 0, long a4 = 0, long a5 = 0) {
+    long ret;
+    register long r10 __asm__("r10") = a3;
+    register long r8 __asm__("r8") = a4;
+    register long r9 __asm__("r9") = a5;
+    __asm__ volatile("syscall"
+            : "=a"(ret)
+            : "a"(nr), "D"(a0), "S"(a1), "d"(a2), "r"(r10), "r"(r8), "r"(r9)
+            : "rcx", "r11", "memory", "cc");
+    return ret;
+}
+
+#elif defined(__i386__)
+
+long rawSyscall(long nr, long a0 = 0, long a1 = 0, long a2 = 0, long a3 = 0, long a4 = 0, long a5 = 0) {
+    long ret;
+    // PIC 代码中 ebx 保存 GOT 指针、ebp 可能是帧指针，不能直接作为约束；
+    // 通过 ecx 指向的参数块装载，调用前后自行保存
+    long args[3] = {a0, a1, a5};
+    long* block = args;
+    __asm__ volatile("push %%ebx\n"
+                     "push %%ebp\n"
+                     "mov 0(%%ecx), %%ebx\n"
+                     "mov 8(%%ecx), %%ebp\n"
+                     "mov 4(%%ecx), %%ecx\n"
+                     "int $0x80\n"
+                     "pop %%ebp\n"
+                     "pop %%ebx"
+            : "=a"(ret), "+c"(block)
+            : "a"(nr), "d"(a2), "S"(a3), "D"(a4)
+            : "memory", "cc");
+    return ret;
+}
+
+#else
+#error "Unsupported ABI for raw syscalls"
+#endif
+
+/**
+ * 把内核返回值转换为 libc 语义
+ */
+long toLibcResult(long result) {
+    if (result < 0 && result > -4096) {
+        errno = static_cast<int>(-result);
+        return -1;
+    }
+    return result;
+}
+
+long arg(const void* pointer) {
+    return reinterpret_cast<long>(pointer);
+}
+
+long arg(size_t value) {
+    return static_cast<long>(value);
+}
+
+#if defined(SYSIO_REPLAY)
+
+thread_local const char* t_replayRoot = nullptr;
+
+/**
+ * 回放模式下的路径改写：绝对路径拼接到当前线程的快照目录之下
+ * 拼接后超长时返回 nullptr，系统调用以 EFAULT 失败，不会落到主机上的真实路径
+ */
+class ReplayPath {
+public:
+    explicit ReplayPath(const char* path) : path_(path) {
+        if (t_replayRoot == nullptr || path == nullptr || path[0] != '/') {
+            return;
+        }
+        int n = snprintf(buffer_, sizeof(buffer_), "%s%s", t_replayRoot, path);
+        path_ = n > 0 && static_cast<size_t>(n) < sizeof(buffer_) ? buffer_ : nullptr;
+    }
+
+    const char* get() const {
+        return path_;
+    }
+
+private:
+    const char* path_;
+    char buffer_[PATH_MAX];
+};
+
+#endif
+
+} // namespace
+
+void setBackend(Backend value) {
+    g_backend.store(value, std::memory_order_relaxed);
+}
+
+Backend backend() {
+    return g_backend.load(std::memory_order_relaxed);
+}
+
+#if defined(SYSIO_REPLAY)
+void setReplayRoot(const char* root) {
+    t_replayRoot = root;
+}
+
+const char* replayRoot() {
+    return t_replayRoot;
+}
+#endif
+
+int openat(int dirFd, const char* path, int flags, mode_t mode) {
+#if defined(SYSIO_REPLAY)
+    ReplayPath replay(path);
+    path = replay.get();
+#endif
+    if (backend() == Backend::Libc) {
+        return ::openat(dirFd, path, flags, mode);
+    }
+#if defined(__LP64__)
+    return static_cast<int>(toLibcResult(rawSyscall(__NR_openat, dirFd, arg(path), flags, mode)));
+#else
+    // 32 位内核需要显式要求大文件支持，和 bionic 的行为一致
+    return static_cast<int>(toLibcResult(rawSyscall(__NR_openat, dirFd, arg(path), flags | O_LARGEFILE, mode)));
+#endif
+}
+
+ssize_t read(int fd, void* buffer, size_t count) {
+    if (backend() == Backend::Libc) {
+        return ::read(fd, buffer, count);
+    }
+    return toLibcResult(rawSyscall(__NR_read, fd, arg(buffer), arg(count)));
+}
+
+ssize_t pread64(int fd, void* buffer, size_t count, int64_t offset) {
+    if (backend() == Backend::Libc) {
+        return ::pread64(fd, buffer, count, offset);
+    }
+#if defined(__LP64__)
+    return toLibcResult(rawSyscall(__NR_pread64, fd, arg(buffer), arg(count), offset));
+#else
+    long low = static_cast<long>(static_cast<uint32_t>(offset));
+    long high = static_cast<long>(static_cast<uint64_t>(offset) >> 32);
+#if defined(__arm__)
+    // ARM EABI 要求 64 位参数落在偶数寄存器对上，r3 空出来
+    return toLibcResult(rawSyscall(__NR_pread64, fd, arg(buffer), arg(count), 0, low, high));
+#else
+    return toLibcResult(rawSyscall(__NR_pread64, fd, arg(buffer), arg(count), low, high));
+#endif
+#endif
+}
+
+long getdents64(int fd, void* buffer, size_t count) {
+    // libc 的 getdents64 直到较新的 API 级别才导出，两种后端都走 syscall
+    if (backend() == Backend::Libc) {
+        return syscall(__NR_getdents64, fd, buffer, count);
+    }
+    return toLibcResult(rawSyscall(__NR_getdents64, fd, arg(buffer), arg(count)));
+}
+
+int close(int fd) {
+    if (backend() == Backend::Libc) {
+        return ::close(fd);
+    }
+    return static_cast<int>(toLibcResult(rawSyscall(__NR_close, fd)));
+}
+
+int fstatat(int dirFd, const char* path, struct stat* st, int flags) {
+#if defined(SYSIO_REPLAY)
+    ReplayPath replay(path);
+    path = replay.get();
+#endif
+    if (backend() == Backend::Libc) {
+        return ::fstatat(dirFd, path, st, flags);
+    }
+#if defined(__LP64__)
+    return static_cast<int>(toLibcResult(rawSyscall(__NR_newfstatat, dirFd, arg(path), arg(st), flags)));
+#else
+    // bionic 32 位的 struct stat 与内核 stat64 布局一致
+    return static_cast<int>(toLibcResult(rawSyscall(__NR_fstatat64, dirFd, arg(path), arg(st), flags)));
+#endif
+}
+
+ssize_t readlinkat(int dirFd, const char* path, char* buffer, size_t size) {
+#if defined(SYSIO_REPLAY)
+    ReplayPath replay(path);
+    path = replay.get();
+#endif
+    if (backend() == Backend::Libc) {
+        return ::readlinkat(dirFd, path, buffer, size);
+    }
+    return toLibcResult(rawSyscall(__NR_readlinkat, dirFd, arg(path), arg(buffer), arg(size)));
+}
+
+int faccessat(int dirFd, const char* path, int mode) {
+#if defined(SYSIO_REPLAY)
+    ReplayPath replay(path);
+    path = replay.get();
+#endif
+    if (backend() == Backend::Libc) {
+        return ::faccessat(dirFd, path, mode, 0);
+    }
+    return static_cast<int>(toLibcResult(rawSyscall(__NR_faccessat, dirFd, arg(path), mode)));
+}
+
+long directSyscall(long nr, long a0, long a1, long a2, long a3) {
+    return rawSyscall(nr, a0, a1, a2, a3);
+}
+
+int rtSigaction(int sig, KernelSigaction* oldAction) {
+    if (backend() == Backend::Libc) {
+        return static_cast<int>(syscall(__NR_rt_sigaction, sig, nullptr, oldAction, sizeof(oldAction->mask)));
+    }
+    return static_cast<int>(toLibcResult(rawSyscall(__NR_rt_sigaction, sig, 0, arg(oldAction),
+                                                    arg(sizeof(oldAction->mask)))));
+}
+
+} // namespace sysio
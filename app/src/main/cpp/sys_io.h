@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "native_api.h"
+
+NATIVE_API_BEGIN
+
+/**
+ * 原始系统调用 I/O 层
+ * 所有 native 检测的文件访问都走这里：默认直接内联 svc/syscall 指令进入内核，
+ * 不经过 libc，Frida/Dobby 对 libc I/O 的 PLT Hook 和 inline Hook 都拦不到；
+ * 也可以在运行时切回 libc 实现做性能对比
+ *
+ * 所有函数保持 libc 语义：失败返回 -1 并设置 errno
+ */
+namespace sysio {
+
+enum class Backend {
+    Libc,
+    Raw
+};
+
+void setBackend(Backend backend);
+Backend backend();
+
+#if defined(SYSIO_REPLAY)
+/**
+ * 回放模式（仅当前线程）：之后的绝对路径都解析到 root 目录下，nullptr 关闭
+ * 只在主机上的离线规则评估（host/rule_eval.cpp）中编译；设备上的库不包含这个入口，
+ * 否则注入代码调用它就能让所有探测读到伪造的目录
+ */
+void setReplayRoot(const char* root);
+const char* replayRoot();
+#endif
+
+int openat(int dirFd, const char* path, int flags, mode_t mode = 0);
+ssize_t read(int fd, void* buffer, size_t count);
+ssize_t pread64(int fd, void* buffer, size_t count, int64_t offset);
+long getdents64(int fd, void* buffer, size_t count);
+int close(int fd);
+int fstatat(int dirFd, const char* path, struct stat* st, int flags);
+ssize_t readlinkat(int dirFd, const char* path, char* buffer, size_t size);
+int faccessat(int dirFd, const char* path, int mode);
+
+/**
+ * 内核 struct sigaction（rt_sigaction 使用的布局）
+ * arm、arm64、x86、x86_64 上字段顺序一致，信号掩码固定 64 位
+ */
+struct KernelSigaction {
+    uintptr_t handler;
+    unsigned long flags;
+    uintptr_t restorer;
+    uint64_t mask;
+};
+
+/**
+ * 只读取内核记录的信号处理函数
+ * libc 的 sigaction 会被 libsigchain 接管，返回的是链上登记的处理函数而不是内核实际使用的
+ */
+int rtSigaction(int sig, KernelSigaction* oldAction);
+
+/**
+ * 不受后端切换影响、始终直接陷入内核的系统调用，返回内核原始结果（失败为 -errno）
+ * 供延迟测量作为不可能被 Hook 的基线
+ */
+long directSyscall(long nr, long a0 = 0, long a1 = 0, long a2 = 0, long a3 = 0);
+
+/**
+ * getdents64 返回的目录项布局（内核 struct linux_dirent64）
+ */
+struct Dirent64 {
+    uint64_t d_ino;
+    int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[];
+};
+
+} // namespace sysio
+
+NATIVE_API_END
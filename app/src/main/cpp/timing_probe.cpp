@@ -0,0 +1,338 @@
+#include "timing_probe.h"
+
+#include <jni.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <ctime>
+#include <vector>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <android/log.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "event_log.h"
+
+#define LOG_TAG "TimingProbe"
+#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN, LOG_TAG, __VA_ARGS__)
+
+namespace {
+
+constexpr int kRounds = 5;
+constexpr int kArithOps = 20000;
+constexpr int kSyscalls = 200;
+constexpr int kChaseSteps = 2000;
+constexpr int kMaxCodeFlushes = 64;
+
+// 指令缓存刷新一项的时间上限：二进制翻译下单次可能高达几十微秒
+constexpr int64_t kCodeFlushBudgetNs = 1000 * 1000;
+
+// 计数器漂移的测量窗口
+constexpr int64_t kDriftWindowNs = 100 * 1000;
+
+// 指针追逐：2MB 数组，下标按满周期 LCG 排列（c 为奇数、a ≡ 1 mod 4），
+// 整个数组构成单个环且访问顺序无规律，硬件预取器跟不上
+constexpr uint32_t kChaseEntries = 1u << 19;
+constexpr uint32_t kChaseMultiplier = 1103515245u;
+constexpr uint32_t kChaseIncrement = 12345u;
+
+/**
+ * 真机上各比值的经验范围（偏保守）
+ * 二进制翻译下指令缓存刷新极其昂贵、访存相对算术变得便宜；
+ * 虚拟化下计数器读取可能陷入、频率与时钟对不上
+ */
+struct TimingBound {
+    const char* name;
+    double min;
+    double max;
+};
+
+const TimingBound kSyscallRatio = {"syscall/arith", 15.0, 2000.0};
+const TimingBound kMemoryRatio = {"memory/arith", 3.0, 400.0};
+const TimingBound kCodeFlushRatio = {"codeflush/arith", 5.0, 5000.0};
+const TimingBound kCounterRead = {"counter read ns", 0.0, 300.0};
+const TimingBound kCounterDrift = {"counter drift ppm", 0.0, 20000.0};
+
+// 至少这么多项越界才判定，单项越界可能只是负载抖动
+constexpr int kMinAnomalies = 2;
+
+double medianOf(double (&samples)[kRounds]) {
+    std::sort(samples, samples + kRounds);
+    return samples[kRounds / 2];
+}
+
+double measureArith() {
+    double samples[kRounds];
+    for (double& sample : samples) {
+        volatile uint64_t seed = 1;
+        uint64_t x = seed;
+        int64_t start = monotonicNowNs();
+        for (int i = 0; i < kArithOps; i++) {
+            x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+        }
+        sample = static_cast<double>(monotonicNowNs() - start) / kArithOps;
+        seed = x;
+    }
+    return medianOf(samples);
+}
+
+double measureSyscall() {
+    double samples[kRounds];
+    for (double& sample : samples) {
+        int64_t start = monotonicNowNs();
+        for (int i = 0; i < kSyscalls; i++) {
+            syscall(__NR_getppid);
+        }
+        sample = static_cast<double>(monotonicNowNs() - start) / kSyscalls;
+    }
+    return medianOf(samples);
+}
+
+/**
+ * 追逐数组只在测量期间存在，测完即释放，不在进程里常驻 2MB
+ */
+double measureMemory() {
+    std::vector<uint32_t> chase(kChaseEntries);
+    for (uint32_t i = 0; i < kChaseEntries; i++) {
+        chase[i] = (i * kChaseMultiplier + kChaseIncrement) & (kChaseEntries - 1);
+    }
+
+    double samples[kRounds];
+    uint32_t index = 0;
+    for (double& sample : samples) {
+        int64_t start = monotonicNowNs();
+        for (int i = 0; i < kChaseSteps; i++) {
+            index = chase[index];
+        }
+        sample = static_cast<double>(monotonicNowNs() - start) / kChaseSteps;
+    }
+    // 让编译器保留追逐链
+    volatile uint32_t sink = index;
+    (void) sink;
+    return medianOf(samples);
+}
+
+/**
+ * 写入 "返回 value" 的机器码
+ */
+size_t emitReturnConstant(uint8_t* code, uint32_t value) {
+#if defined(__aarch64__)
+    const uint32_t insns[] = {0x52800000u | ((value & 0xFFFFu) << 5), 0xD65F03C0u};  // movz w0, #v; ret
+#elif defined(__arm__)
+    const uint32_t insns[] = {0xE3A00000u | (value & 0xFFu), 0xE12FFF1Eu};          // mov r0, #v; bx lr
+#elif defined(__x86_64__) || defined(__i386__)
+    const uint8_t insns[] = {0xB8, static_cast<uint8_t>(value), 0, 0, 0, 0xC3};    // mov eax, v; ret
+#endif
+    memcpy(code, insns, sizeof(insns));
+    return sizeof(insns);
+}
+
+/**
+ * 自修改代码：每次改写立即数并刷新指令缓存后调用
+ * 真机上只是一次 cache 维护；二进制翻译器必须让已翻译的块失效并重新翻译
+ * 每次测量使用自己的代码页并在结束时解除映射，进程中不会残留可写可执行的匿名页
+ */
+double measureCodeFlush() {
+    auto pageSize = static_cast<size_t>(getpagesize());
+    void* page = mmap(nullptr, pageSize, PROT_READ | PROT_WRITE | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (page == MAP_FAILED) {
+        return -1;
+    }
+
+    auto* code = static_cast<uint8_t*>(page);
+    auto fn = reinterpret_cast<uint32_t (*)()>(page);
+    int64_t start = monotonicNowNs();
+    int done = 0;
+    while (done < kMaxCodeFlushes && monotonicNowNs() - start < kCodeFlushBudgetNs) {
+        uint32_t value = static_cast<uint32_t>(done & 0x7F) + 1;
+        size_t len = emitReturnConstant(code, value);
+        __builtin___clear_cache(reinterpret_cast<char*>(code), reinterpret_cast<char*>(code + len));
+        if (fn() != value) {
+            LOGW("Stale code executed after flush");
+        }
+        done++;
+    }
+    double perFlush = static_cast<double>(monotonicNowNs() - start) / done;
+    munmap(page, pageSize);
+    return perFlush;
+}
+
+inline uint64_t readCounter() {
+#if defined(__aarch64__)
+    uint64_t value;
+    asm volatile("isb; mrs %0, cntvct_el0" : "=r"(value) :: "memory");
+    return value;
+#elif defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    // ARMv7 用户态不一定允许访问 CNTVCT，避免 SIGILL
+    return 0;
+#endif
+}
+
+inline uint64_t counterFrequency() {
+#if defined(__aarch64__)
+    uint64_t value;
+    asm volatile("mrs %0, cntfrq_el0" : "=r"(value));
+    return value;
+#else
+    return 0;
+#endif
+}
+
+double measureCounterRead() {
+    if (readCounter() == 0) {
+        return -1;
+    }
+    double samples[kRounds];
+    for (double& sample : samples) {
+        int64_t start = monotonicNowNs();
+        for (int i = 0; i < kSyscalls; i++) {
+            readCounter();
+        }
+        sample = static_cast<double>(monotonicNowNs() - start) / kSyscalls;
+    }
+    return medianOf(samples);
+}
+
+/**
+ * 一个窗口内硬件计数器每纳秒走的刻度
+ */
+double countsPerNs() {
+    int64_t startNs = monotonicNowNs();
+    uint64_t startCount = readCounter();
+    int64_t nowNs;
+    do {
+        nowNs = monotonicNowNs();
+    } while (nowNs - startNs < kDriftWindowNs);
+    uint64_t endCount = readCounter();
+    return static_cast<double>(endCount - startCount) / static_cast<double>(nowNs - startNs);
+}
+
+/**
+ * 多个窗口之间计数器速率的偏差（相对中位数的中位绝对偏差），单个窗口被抢占不会影响结果；
+ * arm64 上再用速率中位数与 CNTFRQ 声明的频率比较，取较大者
+ */
+double measureCounterDrift() {
+    if (readCounter() == 0) {
+        return -1;
+    }
+    double rates[kRounds];
+    for (double& rate : rates) {
+        rate = countsPerNs();
+    }
+    double median = medianOf(rates);
+    if (median <= 0) {
+        return -1;
+    }
+
+    double deviations[kRounds];
+    for (int i = 0; i < kRounds; i++) {
+        deviations[i] = std::fabs(rates[i] - median);
+    }
+    double drift = medianOf(deviations) / median * 1e6;
+
+    uint64_t frequency = counterFrequency();
+    if (frequency != 0) {
+        double declared = static_cast<double>(frequency) / 1e9;
+        double frequencyDrift = std::fabs(median - declared) / declared * 1e6;
+        drift = std::max(drift, frequencyDrift);
+    }
+    return drift;
+}
+
+bool outOfBounds(const TimingBound& bound, double value) {
+    if (value < 0) {
+        return false;
+    }
+    if (value < bound.min || value > bound.max) {
+        LOGW("Timing anomaly: %s = %.2f (expected %.2f-%.2f)", bound.name, value, bound.min, bound.max);
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
+int64_t monotonicNowNs() {
+    struct timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+TimingProfile measureTimingProfile() {
+    TimingProfile profile{};
+    profile.arithNs = measureArith();
+    profile.syscallNs = measureSyscall();
+    profile.memoryNs = measureMemory();
+    profile.codeFlushNs = measureCodeFlush();
+    profile.counterReadNs = measureCounterRead();
+    profile.counterDriftPpm = measureCounterDrift();
+    return profile;
+}
+
+/**
+ * 检测模拟器：时间侧信道
+ * 用算术依赖链做基准单位，比较系统调用、访存、自修改代码的相对开销，
+ * 再看硬件计数器的读取开销和频率，识别二进制翻译（houdini/QEMU TCG）和虚拟化；
+ * 比值与内置的真机范围比较，至少两项越界才判定
+ */
+bool checkTimingAnomaly(TimingProfile& measured) {
+    int64_t start = monotonicNowNs();
+    TimingProfile profile = measureTimingProfile();
+    measured = profile;
+    LOGD("Timing profile in %lld us: arith %.2f, syscall %.1f, memory %.1f, codeflush %.1f, "
+         "counter %.1f ns, drift %.0f ppm",
+         static_cast<long long>((monotonicNowNs() - start) / 1000),
+         profile.arithNs, profile.syscallNs, profile.memoryNs, profile.codeFlushNs,
+         profile.counterReadNs, profile.counterDriftPpm);
+
+    if (profile.arithNs <= 0) {
+        return false;
+    }
+
+    int anomalies = 0;
+    if (outOfBounds(kSyscallRatio, profile.syscallNs / profile.arithNs)) anomalies++;
+    if (outOfBounds(kMemoryRatio, profile.memoryNs / profile.arithNs)) anomalies++;
+    if (profile.codeFlushNs > 0 && outOfBounds(kCodeFlushRatio, profile.codeFlushNs / profile.arithNs)) anomalies++;
+    if (outOfBounds(kCounterRead, profile.counterReadNs)) anomalies++;
+    if (outOfBounds(kCounterDrift, profile.counterDriftPpm)) anomalies++;
+    return anomalies >= kMinAnomalies;
+}
+
+void timingProfileValues(const TimingProfile& profile, int64_t (&values)[kTimingProfileValues]) {
+    values[0] = static_cast<int64_t>(profile.arithNs * 1000);
+    values[1] = static_cast<int64_t>(profile.syscallNs * 1000);
+    values[2] = static_cast<int64_t>(profile.memoryNs * 1000);
+    values[3] = static_cast<int64_t>(profile.codeFlushNs * 1000);
+    values[4] = static_cast<int64_t>(profile.counterReadNs * 1000);
+    values[5] = static_cast<int64_t>(profile.counterDriftPpm);
+}
+
+/**
+ * 单独运行一次微基准并导出（见 timingProfileValues），作为设备性能探针使用
+ */
+extern "C"
+JNIEXPORT jlongArray JNICALL
+Java_com_grtsinry43_environmentdetector_security_NativeSecurityDetector_nativeGetTimingProfile(
+        JNIEnv* env,
+        jclass clazz) {
+
+    EVLOG_D(CheckStarted, CheckId::TimingProfile);
+
+    int64_t values[kTimingProfileValues];
+    timingProfileValues(measureTimingProfile(), values);
+
+    jlong exported[kTimingProfileValues];
+    std::copy(values, values + kTimingProfileValues, exported);
+    jlongArray result = env->NewLongArray(kTimingProfileValues);
+    if (result != nullptr) {
+        env->SetLongArrayRegion(result, 0, kTimingProfileValues, exported);
+    }
+    return result;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "native_api.h"
+
+NATIVE_API_BEGIN
+
+/**
+ * 一组微基准的测量结果，时间单位为纳秒
+ * 既用于识别二进制翻译/虚拟化，也可以单独作为设备性能探针
+ * 某项在当前平台不可测时为负数
+ */
+struct TimingProfile {
+    double arithNs;          // 依赖链整数乘加，每次操作
+    double syscallNs;        // getppid 系统调用往返
+    double memoryNs;         // 随机指针追逐，每次加载
+    double codeFlushNs;      // 改写一条指令、刷新指令缓存并调用
+    double counterReadNs;    // 读取硬件计数器（CNTVCT_EL0 / rdtsc）
+    double counterDriftPpm;  // 硬件计数器相对 CLOCK_MONOTONIC 的频率偏差（百万分比）
+};
+
+/**
+ * 运行整套微基准，总耗时控制在 5ms 以内
+ */
+TimingProfile measureTimingProfile();
+
+/**
+ * 测量一次并与内置的真机范围比较；measured 返回这次的测量结果，调用方记录时不必重新测量
+ */
+bool checkTimingAnomaly(TimingProfile& measured);
+
+/**
+ * 导出格式：顺序与 TimingProfile 字段一致，时间单位为皮秒（漂移为 ppm）
+ */
+constexpr size_t kTimingProfileValues = 6;
+
+void timingProfileValues(const TimingProfile& profile, int64_t (&values)[kTimingProfileValues]);
+
+/**
+ * 单调时钟，纳秒
+ */
+int64_t monotonicNowNs();
+
+NATIVE_API_END
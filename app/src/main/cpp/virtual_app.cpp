@@ -0,0 +1,255 @@
+#include <jni.h>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unistd.h>
+#include <android/log.h>
+
+#include "event_log.h"
+#include "proc_snapshot.h"
+
+#define LOG_TAG "VirtualApp"
+#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#define LOGW(...) __android_log_print(ANDROID_LOG_WARN, LOG_TAG, __VA_ARGS__)
+
+namespace {
+
+constexpr uid_t kPerUserRange = 100000;
+
+// 合法地被映射进任意应用进程的其它包：WebView 提供者、GMS 动态模块
+const char* const kSharedPackageKeywords[] = {
+        "webview",
+        "chrome",
+        "trichrome",
+        "com.google.android.gms",
+        "com.google.android.gsf"
+};
+
+enum PathClass : uint8_t {
+    kPathUnclassified = 0,
+    kPathUnrelated,
+    kPathOwn,
+    kPathShared,
+    kPathForeign
+};
+
+bool startsWith(std::string_view str, std::string_view prefix) {
+    return str.size() >= prefix.size() && str.compare(0, prefix.size(), prefix) == 0;
+}
+
+bool endsWith(std::string_view str, std::string_view suffix) {
+    return str.size() >= suffix.size() &&
+           str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+std::string_view nextSegment(std::string_view path, size_t& pos) {
+    size_t end = path.find('/', pos);
+    if (end == std::string_view::npos) end = path.size();
+    std::string_view segment = path.substr(pos, end - pos);
+    pos = end + 1;
+    return segment;
+}
+
+/**
+ * 去掉应用数据分区的根：内部存储 /data，或可移动存储（adopted storage）的 /mnt/expand/<uuid>
+ * 两者之下的布局相同，返回根之后以 '/' 开头的部分，不在其中时返回空
+ */
+std::string_view stripVolumeRoot(std::string_view path) {
+    if (startsWith(path, "/data/")) {
+        return path.substr(strlen("/data"));
+    }
+    if (startsWith(path, "/mnt/expand/")) {
+        size_t pos = strlen("/mnt/expand/");
+        std::string_view uuid = nextSegment(path, pos);
+        if (!uuid.empty() && pos <= path.size()) {
+            return path.substr(pos - 1);
+        }
+    }
+    return {};
+}
+
+/**
+ * 从应用相关路径中提取包名（根为 /data 或 /mnt/expand/<uuid>）
+ * <root>/app/<pkg>-<suffix>/...、<root>/app/~~<rand>==/<pkg>-<suffix>/...
+ * <root>/data/<pkg>/...、<root>/user/<n>/<pkg>/...、<root>/user_de/<n>/<pkg>/...
+ */
+bool extractPackage(std::string_view path, std::string_view& package) {
+    path = stripVolumeRoot(path);
+    size_t pos = 0;
+    if (startsWith(path, "/app/")) {
+        pos = strlen("/app/");
+        std::string_view segment = nextSegment(path, pos);
+        if (startsWith(segment, "~~")) {
+            segment = nextSegment(path, pos);
+        }
+        // 包名中不允许出现 '-'，第一个 '-' 之后是安装后缀
+        package = segment.substr(0, segment.find('-'));
+    } else if (startsWith(path, "/data/")) {
+        pos = strlen("/data/");
+        package = nextSegment(path, pos);
+    } else if (startsWith(path, "/user/") || startsWith(path, "/user_de/")) {
+        pos = path.find('/', 1) + 1;
+        nextSegment(path, pos);
+        package = nextSegment(path, pos);
+    } else {
+        return false;
+    }
+    return !package.empty();
+}
+
+bool isSharedPackage(std::string_view package) {
+    for (const char* keyword : kSharedPackageKeywords) {
+        if (package.find(keyword) != std::string_view::npos) {
+            return true;
+        }
+    }
+    return false;
+}
+
+PathClass classifyPath(std::string_view path, std::string_view ownPackage) {
+    std::string_view package;
+    if (!extractPackage(path, package)) {
+        return kPathUnrelated;
+    }
+    if (package == ownPackage) {
+        return kPathOwn;
+    }
+    return isSharedPackage(package) ? kPathShared : kPathForeign;
+}
+
+bool isCodePath(std::string_view path) {
+    return endsWith(path, ".dex") || endsWith(path, ".odex") ||
+           endsWith(path, ".vdex") || endsWith(path, ".oat");
+}
+
+/**
+ * 单次遍历 maps：统计执行了代码的外部包
+ * 路径分类按驻留 id 缓存，同一文件的多段映射只分类一次
+ */
+int countForeignCodePackages(const MapsSnapshot& maps, std::string_view ownPackage) {
+    const PathInterner& paths = maps.paths();
+    std::vector<uint8_t> classes(paths.size(), kPathUnclassified);
+    std::vector<uint8_t> reported(paths.size(), 0);
+
+    int foreignCode = 0;
+
+    for (const MapEntry& entry : maps.entries()) {
+        if (entry.pathId == 0) continue;
+
+        uint8_t& cls = classes[entry.pathId];
+        const std::string& path = paths.path(entry.pathId);
+        if (cls == kPathUnclassified) {
+            cls = classifyPath(path, ownPackage);
+        }
+
+        if (cls != kPathForeign || reported[entry.pathId]) continue;
+        if ((entry.perms & kMapExec) != 0 || isCodePath(path)) {
+            reported[entry.pathId] = 1;
+            foreignCode++;
+            EVLOG_W(ForeignPackageCode, eventlog::intern(path));
+        }
+    }
+
+    return foreignCode;
+}
+
+/**
+ * 进程名必须是包名，或者 "包名:子进程名"
+ */
+bool checkProcessName(const std::string& cmdline, std::string_view ownPackage) {
+    std::string_view name(cmdline.c_str());
+    if (name == ownPackage) return false;
+    if (startsWith(name, ownPackage) && name.size() > ownPackage.size() &&
+        name[ownPackage.size()] == ':') {
+        return false;
+    }
+    LOGW("Process name does not belong to our package: %s", cmdline.c_str());
+    return true;
+}
+
+/**
+ * dataDir 必须是 /data/user/<userId>/<pkg>、/data/data/<pkg>，
+ * 或装在可移动存储上时的 /mnt/expand/<uuid>/user/<userId>/<pkg>
+ * VirtualApp 类宿主会把它重定向到宿主自己的数据目录下
+ */
+bool checkDataDir(std::string_view dataDir, std::string_view ownPackage) {
+    std::string pkg(ownPackage);
+    char expected[256];
+
+    snprintf(expected, sizeof(expected), "/user/%u/%s",
+             static_cast<unsigned>(getuid() / kPerUserRange), pkg.c_str());
+    std::string_view relative = stripVolumeRoot(dataDir);
+    if (!relative.empty() && relative == expected) return false;
+
+    snprintf(expected, sizeof(expected), "/data/data/%s", pkg.c_str());
+    if (dataDir == expected) return false;
+
+    LOGW("Unexpected data dir: %.*s", static_cast<int>(dataDir.size()), dataDir.data());
+    return true;
+}
+
+/**
+ * 实际运行的 uid 必须与 ApplicationInfo 声明的 app id 一致
+ */
+bool checkUid(int expectedUid) {
+    uid_t uid = getuid();
+    if (uid % kPerUserRange != static_cast<uid_t>(expectedUid) % kPerUserRange) {
+        LOGW("UID mismatch: running as %u, expected app id of %d", uid, expectedUid);
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
+/**
+ * 检测多开/虚拟应用宿主
+ * Parallel Space、VirtualApp 等会把我们的 APK 加载进宿主进程运行
+ */
+bool checkVirtualApp(const char* packageName, const char* dataDir, int expectedUid) {
+    std::string_view ownPackage(packageName);
+    ProcSnapshot& snapshot = currentSnapshot();
+
+    bool detected = false;
+
+    if (countForeignCodePackages(snapshot.maps(), ownPackage) > 0) detected = true;
+    if (snapshot.available(ProcFile::Cmdline) &&
+        checkProcessName(snapshot.get(ProcFile::Cmdline), ownPackage)) {
+        detected = true;
+    }
+    if (checkDataDir(dataDir, ownPackage)) detected = true;
+    if (checkUid(expectedUid)) detected = true;
+
+    return detected;
+}
+
+extern "C"
+JNIEXPORT jboolean JNICALL
+Java_com_grtsinry43_environmentdetector_security_NativeSecurityDetector_nativeCheckVirtualApp(
+        JNIEnv* env,
+        jclass clazz,
+        jstring packageName,
+        jstring dataDir,
+        jint expectedUid) {
+
+    EVLOG_D(CheckStarted, CheckId::VirtualApp);
+
+    if (packageName == nullptr || dataDir == nullptr) {
+        return false;
+    }
+
+    const char* packageStr = env->GetStringUTFChars(packageName, nullptr);
+    const char* dataDirStr = env->GetStringUTFChars(dataDir, nullptr);
+
+    // 内存不足时返回 nullptr 并挂起 OutOfMemoryError，交给 Java 层处理
+    bool isVirtual = packageStr != nullptr && dataDirStr != nullptr &&
+                     checkVirtualApp(packageStr, dataDirStr, expectedUid);
+
+    if (dataDirStr != nullptr) env->ReleaseStringUTFChars(dataDir, dataDirStr);
+    if (packageStr != nullptr) env->ReleaseStringUTFChars(packageName, packageStr);
+
+    EVLOG_I(CheckResult, CheckId::VirtualApp, isVirtual);
+    return isVirtual;
+}
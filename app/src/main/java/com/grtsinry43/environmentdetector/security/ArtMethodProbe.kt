@@ -0,0 +1,17 @@
+package com.grtsinry43.environmentdetector.security
+
+/**
+ * ArtMethod 大小探针
+ * native 层通过两个相邻直接方法的 ArtMethod 地址差计算结构体大小，
+ * dex 中直接方法按名字排序，first/second 在方法数组中必然相邻
+ */
+internal object ArtMethodProbe {
+
+    @JvmStatic
+    fun first() {
+    }
+
+    @JvmStatic
+    fun second() {
+    }
+}
@@ -18,6 +18,9 @@ import java.io.InputStreamReader
 class EmulatorDetector(private val context: Context) : IDetector {
 
     companion object {
+        // 设备历史不足时，缺失关键传感器数量的回退阈值（超过即判定）
+        private const val MISSING_SENSORS_THRESHOLD = 2
+
         // 已知的模拟器特征值
         private val KNOWN_EMULATOR_MANUFACTURERS = setOf("Genymotion", "unknown", "Google", "Android")
         private val KNOWN_EMULATOR_MODELS = setOf(
@@ -192,8 +195,11 @@ class EmulatorDetector(private val context: Context) : IDetector {
             if (!hasProximity) missingSensors.add("Proximity")
             if (!hasLight) missingSensors.add("Light")
 
-            // 如果缺少 3 个以上关键传感器，很可能是模拟器
-            if (missingSensors.size >= 3) {
+            // 低端机本来就可能缺陀螺仪、磁力计等，和本设备的历史比较；历史不足时缺少 3 个以上才判定
+            if (NativeSecurityDetector.isCountAbnormal(
+                    context, NativeSecurityDetector.METRIC_MISSING_SENSORS, missingSensors.size, MISSING_SENSORS_THRESHOLD
+                )
+            ) {
                 return DetectionItem(
                     type = DetectionType.EMULATOR,
                     description = "Multiple critical sensors missing",
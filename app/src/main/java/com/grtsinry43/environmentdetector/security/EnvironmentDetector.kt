@@ -3,8 +3,12 @@ package com.grtsinry43.environmentdetector.security
 import android.content.Context
 import android.util.Log
 import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Deferred
 import kotlinx.coroutines.Dispatchers
-import kotlinx.coroutines.launch
+import kotlinx.coroutines.SupervisorJob
+import kotlinx.coroutines.async
+import kotlinx.coroutines.sync.Mutex
+import kotlinx.coroutines.sync.withLock
 import kotlinx.coroutines.withContext
 
 /**
@@ -38,10 +42,26 @@ class EnvironmentDetector(private val context: Context) {
 
     private val nativeDetector = NativeSecurityDetector()
 
+    // 扫描在检测器自己的作用域中执行，单个调用者取消不会中断其他调用者在等待的扫描
+    private val scans = ScanSingleFlight(CoroutineScope(SupervisorJob() + Dispatchers.IO))
+
     /**
      * 执行全面的环境检测
+     * @param maxAgeMs 大于 0 时，该时间窗内完成的上一次结果直接复用
+     */
+    suspend fun performFullDetection(maxAgeMs: Long = 0): DetectionResult {
+        return scans.run(ScanProfile.FULL, maxAgeMs) { runFullDetection() }
+    }
+
+    /**
+     * 快速检测（只执行关键项目）
+     * @param maxAgeMs 同上
      */
-    suspend fun performFullDetection(): DetectionResult {
+    suspend fun performQuickDetection(maxAgeMs: Long = 0): DetectionResult {
+        return scans.run(ScanProfile.QUICK, maxAgeMs) { runQuickDetection() }
+    }
+
+    private suspend fun runFullDetection(): DetectionResult {
         return withContext(Dispatchers.IO) {
             val results = mutableListOf<DetectionItem>()
             val startTime = System.currentTimeMillis()
@@ -76,7 +96,7 @@ class EnvironmentDetector(private val context: Context) {
 
             // 执行 Native 层检测
             try {
-                val nativeResults = nativeDetector.performNativeDetection(context)
+                val nativeResults = nativeDetector.performNativeDetection(context, ScanProfile.FULL)
                 results.addAll(nativeResults)
             } catch (e: Exception) {
                 Log.e(TAG, "Native detection failed", e)
@@ -97,10 +117,7 @@ class EnvironmentDetector(private val context: Context) {
         }
     }
 
-    /**
-     * 快速检测（只执行关键项目）
-     */
-    suspend fun performQuickDetection(): DetectionResult {
+    private suspend fun runQuickDetection(): DetectionResult {
         return withContext(Dispatchers.IO) {
             val results = mutableListOf<DetectionItem>()
 
@@ -118,6 +135,13 @@ class EnvironmentDetector(private val context: Context) {
                 }
             }
 
+            // 只执行引导库中的 native 检测，不加载任何扫描模块
+            try {
+                results.addAll(nativeDetector.performNativeDetection(context, ScanProfile.QUICK))
+            } catch (e: Exception) {
+                Log.e(TAG, "Quick native detection failed", e)
+            }
+
             DetectionResult(
                 isClean = results.none { it.isAbnormal },
                 detectionItems = results,
@@ -128,6 +152,66 @@ class EnvironmentDetector(private val context: Context) {
     }
 }
 
+/**
+ * 单飞：同一扫描配置同时只执行一次，并发的请求加入进行中的扫描并共享结果
+ * 连续点击、配置变更重建界面、多个调用方同时请求时，实际执行的扫描次数与调用方数量无关
+ * @param onScanFinished 每次实际执行的扫描结束后调用（成功或失败），默认把计数基线落盘
+ */
+internal class ScanSingleFlight(
+    private val scanScope: CoroutineScope,
+    private val onScanFinished: () -> Unit = { NativeSecurityDetector.flushBaseline() }
+) {
+    private val scanLock = Mutex()
+    private val inFlight = mutableMapOf<ScanProfile, Deferred<DetectionResult>>()
+    private val lastResults = mutableMapOf<ScanProfile, DetectionResult>()
+
+    /**
+     * @param maxAgeMs 大于 0 时，该时间窗内完成的上一次结果直接复用
+     */
+    suspend fun run(
+        profile: ScanProfile,
+        maxAgeMs: Long,
+        scan: suspend () -> DetectionResult
+    ): DetectionResult {
+        val deferred = scanLock.withLock {
+            val last = lastResults[profile]
+            if (maxAgeMs > 0 && last != null && System.currentTimeMillis() - last.timestamp <= maxAgeMs) {
+                Log.d(TAG, "Reusing $profile result from ${System.currentTimeMillis() - last.timestamp}ms ago")
+                return last
+            }
+
+            inFlight[profile]?.let {
+                Log.d(TAG, "Joining in-flight $profile detection")
+                return@withLock it
+            }
+
+            scanScope.async {
+                try {
+                    scan().also { result -> scanLock.withLock { lastResults[profile] = result } }
+                } finally {
+                    onScanFinished()
+                    scanLock.withLock { inFlight.remove(profile) }
+                }
+            }.also { inFlight[profile] = it }
+        }
+        return deferred.await()
+    }
+
+    private companion object {
+        const val TAG = "ScanSingleFlight"
+    }
+}
+
+/**
+ * 扫描配置，单飞按配置区分
+ * nativeModules 为该配置需要按需加载的 native 扫描模块；QUICK 只用引导库，
+ * 只做快速检测时扫描模块始终不会被加载
+ */
+enum class ScanProfile(val nativeModules: Set<NativeModule>) {
+    FULL(NativeModule.values().toSet()),
+    QUICK(emptySet())
+}
+
 /**
  * 检测结果
  */
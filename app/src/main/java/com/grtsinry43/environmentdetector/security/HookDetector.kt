@@ -15,6 +15,9 @@ import java.lang.reflect.Modifier
 class HookDetector(private val context: Context) : IDetector {
 
     companion object {
+        // 设备历史不足时的 dexElements 回退阈值
+        private const val DEX_ELEMENTS_THRESHOLD = 10
+
         // Hook 框架的典型类名特征（用于栈帧分析）
         private val HOOK_CLASS_PATTERNS = listOf(
             "de.robv.android.xposed",
@@ -144,8 +147,11 @@ class HookDetector(private val context: Context) : IDetector {
                     dexElementsField.isAccessible = true
                     val dexElements = dexElementsField.get(pathList) as Array<*>
 
-                    // 正常应用的 dex 数量有限
-                    if (dexElements.size > 10) {
+                    // 正常应用的 dex 数量有限，且同一安装包在同一设备上基本不变，和历史比较
+                    if (NativeSecurityDetector.isCountAbnormal(
+                            context, NativeSecurityDetector.METRIC_DEX_ELEMENTS, dexElements.size, DEX_ELEMENTS_THRESHOLD
+                        )
+                    ) {
                         return DetectionItem(
                             type = DetectionType.HOOK_XPOSED,
                             description = "Abnormal number of dex files loaded",
@@ -1,7 +1,20 @@
 package com.grtsinry43.environmentdetector.security
 
 import android.content.Context
+import android.content.ContentResolver
+import android.content.pm.ApplicationInfo
+import android.os.Debug
+import android.provider.Settings
 import android.util.Log
+import java.io.File
+import java.lang.reflect.Member
+import java.security.KeyStore
+import java.security.SecureRandom
+import java.util.concurrent.ConcurrentHashMap
+import javax.net.ssl.KeyManager
+import javax.net.ssl.SSLContext
+import javax.net.ssl.TrustManager
+import javax.net.ssl.TrustManagerFactory
 
 /**
  * Native 层安全检测器
@@ -11,14 +24,36 @@ class NativeSecurityDetector {
 
     companion object {
         private const val TAG = "NativeSecurityDetector"
+
+        // 计数类指标，编号与 native 层 Metric 枚举一致
+        const val METRIC_FD_COUNT = 0
+        const val METRIC_BIND_MOUNTS = 1
+        const val METRIC_DEX_ELEMENTS = 2
+        const val METRIC_MISSING_SENSORS = 3
+
+        // nativeObserveMetric 的返回值
+        private const val VERDICT_LEARNING = -1
+        private const val VERDICT_NORMAL = 0
+        private const val VERDICT_ANOMALOUS = 1
+
+        private const val BASELINE_FILE = "native_baseline.bin"
+        private const val BOOTSTRAP_LIBRARY = "security_native"
         private var isNativeLibraryLoaded = false
+        @Volatile
         private var isInitialized = false
 
+        // 加载耗时（纳秒），加载失败的模块记为 -1
+        private var bootstrapLoadNs = 0L
+        private val moduleLoadNs = ConcurrentHashMap<NativeModule, Long>()
+        private val moduleLock = Any()
+
         init {
             try {
-                System.loadLibrary("security_native")
+                val start = System.nanoTime()
+                System.loadLibrary(BOOTSTRAP_LIBRARY)
+                bootstrapLoadNs = System.nanoTime() - start
                 isNativeLibraryLoaded = true
-                Log.d(TAG, "Native security library loaded successfully")
+                Log.d(TAG, "Native security library loaded successfully in ${bootstrapLoadNs / 1000}us")
             } catch (e: UnsatisfiedLinkError) {
                 Log.e(TAG, "Failed to load native security library", e)
                 isNativeLibraryLoaded = false
@@ -53,6 +88,205 @@ class NativeSecurityDetector {
         @JvmStatic
         external fun nativeCheckEmulator(): Boolean
 
+        /**
+         * Native 挂载命名空间检测
+         * 检测：与 init/zygote 的 mountinfo 差异、Magisk/KernelSU 挂载特征
+         */
+        @JvmStatic
+        external fun nativeCheckMountNamespace(): Boolean
+
+        /**
+         * Native 虚拟环境检测
+         * 检测：命名空间 inode、uid_map、NSpid、cgroup 容器特征
+         */
+        @JvmStatic
+        external fun nativeCheckVirtualEnvironment(): Boolean
+
+        /**
+         * Native 多开/虚拟应用检测
+         * 检测：maps 中外部包的代码映射、进程名、dataDir、uid
+         */
+        @JvmStatic
+        external fun nativeCheckVirtualApp(packageName: String, dataDir: String, expectedUid: Int): Boolean
+
+        /**
+         * Native 链接器一致性检测
+         * 检测：dl_iterate_phdr 与 maps 可执行映射的差异（从 soinfo 摘除的模块）
+         */
+        @JvmStatic
+        external fun nativeCheckLinkerConsistency(): Boolean
+
+        /**
+         * Native 隐藏内存区域探测（增量）
+         * 检测：maps 间隙中存在、但 maps 未报告的映射；每次调用只消耗固定的探测预算
+         */
+        @JvmStatic
+        external fun nativeProbeHiddenRegions(): Boolean
+
+        /**
+         * Native 映射视图一致性检测
+         * 检测：maps、smaps、map_files 三个视图之间稳定存在的差异（被过滤的 maps 读取）
+         */
+        @JvmStatic
+        external fun nativeCheckMapsConsistency(): Boolean
+
+        /**
+         * Native 代码页篡改检测
+         * 检测：可执行文件映射中的私有脏页（smaps + pagemap 定位，与磁盘文件比对）
+         */
+        @JvmStatic
+        external fun nativeCheckDirtyCodePages(): Boolean
+
+        /**
+         * Native ArtMethod 入口完整性检测
+         * 检测：敏感方法的 quick 入口不在 libart/oat/JIT 缓存中，或 native 标志被改写
+         * 首次调用时解析并缓存方法，之后的调用忽略参数
+         */
+        @JvmStatic
+        external fun nativeCheckArtMethods(methods: Array<Member>): Boolean
+
+        /**
+         * Native 软件断点检测
+         * 检测：本库代码段中新增的 BRK/BKPT/INT3 或与文件不一致的代码页
+         */
+        @JvmStatic
+        external fun nativeCheckCodeBreakpoints(): Boolean
+
+        /**
+         * Native 信号处理函数审计
+         * 检测：所有信号在 libsigchain 和内核视图中位于注入代码里的处理函数
+         */
+        @JvmStatic
+        external fun nativeCheckSignalHandlers(): Boolean
+
+        /**
+         * Native 进程血缘检测
+         * 检测：父进程不是 zygote 家族（frida-server spawn、gdbserver、app_process 包装器）
+         */
+        @JvmStatic
+        external fun nativeCheckProcessLineage(): Boolean
+
+        /**
+         * Native 文件描述符分类检测
+         * 检测：linjector FIFO、frida 命名的 memfd/套接字、连到 Frida 端口的 TCP 连接
+         */
+        @JvmStatic
+        external fun nativeCheckFileDescriptors(): Boolean
+
+        /**
+         * Native 本机监听端口 D-Bus 握手探测
+         * 检测：任意端口上回应 D-Bus AUTH 握手的服务（自定义端口的 frida-server），总时限 50ms
+         */
+        @JvmStatic
+        external fun nativeProbeDbusListeners(): Boolean
+
+        /**
+         * Native 微基准性能探针
+         * 返回：算术、系统调用、访存、指令缓存刷新、计数器读取耗时（皮秒）和计数器漂移（ppm）
+         * 某项不可测时为负数
+         */
+        @JvmStatic
+        external fun nativeGetTimingProfile(): LongArray
+
+        /**
+         * Native 热点 libc/JNI 函数调用延迟检测
+         * 与内联系统调用、少被 Hook 的 JNI 函数交替计时，比较中位数
+         */
+        @JvmStatic
+        external fun nativeCheckCallLatency(): Boolean
+
+        /**
+         * Native 加载时基线检测
+         * 比较库构造函数在 System.loadLibrary 期间采集的状态（tracer、线程、环境变量、内存映射）
+         */
+        @JvmStatic
+        external fun nativeCheckEarlyStage(): Boolean
+
+        /**
+         * 切换 native 层的 I/O 后端
+         * true 为内联系统调用（默认，绕过 libc Hook），false 为 libc，用于基准对比
+         */
+        @JvmStatic
+        external fun nativeSetRawSyscallIo(enabled: Boolean)
+
+        /**
+         * 开始新一轮扫描，重置当前线程的 native 扫描上下文（procfs 快照、发现记录）
+         * 扫描上下文按线程隔离，不同线程可以同时扫描
+         */
+        @JvmStatic
+        external fun nativeBeginScan()
+
+        /**
+         * 当前线程本轮扫描中指定来源的最近一条发现，没有时为 null
+         */
+        @JvmStatic
+        external fun nativeGetScanFinding(source: String): String?
+
+        /**
+         * 结束当前线程的扫描，返回本轮 native 层记录的发现（"来源: 消息"）
+         */
+        @JvmStatic
+        external fun nativeEndScan(): Array<String>
+
+        /**
+         * 导出 native 事件日志（环形缓冲区中保留的最近记录，导出时才格式化）
+         */
+        @JvmStatic
+        external fun nativeDumpEventLog(): String
+
+        /**
+         * 指定设备基线的持久化文件并载入历史
+         */
+        @JvmStatic
+        external fun nativeInitBaselineStore(path: String)
+
+        /**
+         * 记录一次计数观测并与本设备历史比较，学习期按 warmupThreshold 判定
+         * 返回：-1 没有基线文件，0 正常，1 显著偏离历史（学习期为超过 warmupThreshold）
+         */
+        @JvmStatic
+        external fun nativeObserveMetric(metric: Int, value: Int, warmupThreshold: Int): Int
+
+        /**
+         * 把本轮扫描更新过的基线写回文件
+         */
+        @JvmStatic
+        external fun nativeFlushBaselineStore()
+
+        /**
+         * 启动 native 后台监控线程（SCHED_IDLE、绑定小核）
+         * 结果稳定时逐步拉长间隔，出现新风险时收紧，CPU 降频期间跳过当轮
+         */
+        @JvmStatic
+        external fun nativeStartMonitor()
+
+        /**
+         * 停止后台监控线程
+         */
+        @JvmStatic
+        external fun nativeStopMonitor()
+
+        /**
+         * 后台监控报告
+         * 返回：检测轮数、降频暂停次数、当前间隔（毫秒）、风险掩码、小核数量、
+         * 累计 CPU 时间（微秒）、运行时长（毫秒）、每小时 CPU 毫秒数
+         */
+        @JvmStatic
+        external fun nativeGetMonitorReport(): LongArray
+
+        /**
+         * 后台监控最近一轮中报告风险的检测项名称
+         */
+        @JvmStatic
+        external fun nativeGetMonitorRisks(): Array<String>
+
+        /**
+         * 一组 native 库（不带 lib 前缀和 .so 后缀）各自所有映射的常驻内存，单位 KB，只读一遍 smaps
+         * 未加载的库为 0，smaps 不可读时全部为 -1
+         */
+        @JvmStatic
+        external fun nativeGetLibraryRss(libraryNames: Array<String>): LongArray
+
         /**
          * 初始化反 Hook 保护
          * 必须在检测前调用
@@ -60,6 +294,173 @@ class NativeSecurityDetector {
         @JvmStatic
         external fun initAntiHook(context: Context)
 
+        /**
+         * 常被 Hook 用来绕过检测的敏感方法
+         * 单个方法解析失败（ROM 差异）时跳过
+         */
+        private val sensitiveMethods: Array<Member> by lazy {
+            val lookups = listOf<() -> Member>(
+                {
+                    SSLContext::class.java.getMethod(
+                        "init",
+                        Array<KeyManager>::class.java,
+                        Array<TrustManager>::class.java,
+                        SecureRandom::class.java
+                    )
+                },
+                { TrustManagerFactory::class.java.getMethod("init", KeyStore::class.java) },
+                { Class::class.java.getMethod("forName", String::class.java) },
+                { Runtime::class.java.getMethod("exec", String::class.java) },
+                { File::class.java.getMethod("exists") },
+                { System::class.java.getMethod("getProperty", String::class.java) },
+                { System::class.java.getMethod("getenv", String::class.java) },
+                { Debug::class.java.getMethod("isDebuggerConnected") },
+                {
+                    Settings.Secure::class.java.getMethod(
+                        "getString",
+                        ContentResolver::class.java,
+                        String::class.java
+                    )
+                },
+                { ClassLoader::class.java.getMethod("loadClass", String::class.java) },
+                { Throwable::class.java.getMethod("getStackTrace") }
+            )
+            lookups.mapNotNull { lookup ->
+                try {
+                    lookup()
+                } catch (e: Exception) {
+                    null
+                }
+            }.toTypedArray()
+        }
+
+        /**
+         * PackageManager 是抽象类，Hook 实际落在 ApplicationPackageManager 的实现上
+         */
+        private fun packageManagerMethods(context: Context): List<Member> {
+            return try {
+                listOf(
+                    context.packageManager.javaClass.getMethod(
+                        "getPackageInfo",
+                        String::class.java,
+                        Int::class.javaPrimitiveType
+                    )
+                )
+            } catch (e: Exception) {
+                emptyList()
+            }
+        }
+
+        /**
+         * 计数类启发式的判定：与本设备自己的历史基线比较（EWMA 均值与方差）
+         * 固定阈值只在历史样本不足时使用，之后正常水平本来就高的设备不会再被它误报；
+         * 连续多次偏离后 native 层会接受新的水平；native 库不可用时只按固定阈值判定
+         */
+        fun isCountAbnormal(context: Context, metric: Int, value: Int, fallbackThreshold: Int): Boolean {
+            if (isNativeLibraryLoaded) {
+                initialize(context)
+                when (nativeObserveMetric(metric, value, fallbackThreshold)) {
+                    VERDICT_NORMAL -> return false
+                    VERDICT_ANOMALOUS -> return true
+                    VERDICT_LEARNING -> Unit
+                }
+            }
+            return value > fallbackThreshold
+        }
+
+        /**
+         * 一轮扫描结束后调用，计数观测只在这里落盘一次；库不可用时忽略
+         */
+        fun flushBaseline() {
+            if (isNativeLibraryLoaded) {
+                nativeFlushBaselineStore()
+            }
+        }
+
+        /**
+         * 附在问题报告中的 native 事件日志；库未加载时为空
+         */
+        fun dumpEventLog(): String {
+            return if (isNativeLibraryLoaded) nativeDumpEventLog() else ""
+        }
+
+        /**
+         * 启动后台持续监控；库不可用时忽略
+         */
+        fun startBackgroundMonitor(context: Context) {
+            if (!isNativeLibraryLoaded) {
+                return
+            }
+            initialize(context)
+            nativeStartMonitor()
+        }
+
+        fun stopBackgroundMonitor() {
+            if (isNativeLibraryLoaded) {
+                nativeStopMonitor()
+            }
+        }
+
+        /**
+         * 后台监控的开销报告，字段顺序见 nativeGetMonitorReport；库未加载时为空
+         */
+        fun monitorReport(): LongArray {
+            return if (isNativeLibraryLoaded) nativeGetMonitorReport() else LongArray(0)
+        }
+
+        /**
+         * 后台监控最近一轮发现的风险，库未加载或监控未运行过时为空
+         */
+        fun monitorRisks(): List<String> {
+            return if (isNativeLibraryLoaded) nativeGetMonitorRisks().toList() else emptyList()
+        }
+
+        /**
+         * 首次需要时加载扫描模块，返回模块是否可用；加载失败不会重试
+         */
+        private fun ensureModule(module: NativeModule): Boolean {
+            if (!isNativeLibraryLoaded) {
+                return false
+            }
+            moduleLoadNs[module]?.let { return it >= 0 }
+            synchronized(moduleLock) {
+                moduleLoadNs[module]?.let { return it >= 0 }
+                val start = System.nanoTime()
+                val loadNs = try {
+                    System.loadLibrary(module.libraryName)
+                    System.nanoTime() - start
+                } catch (e: UnsatisfiedLinkError) {
+                    Log.e(TAG, "Failed to load native module ${module.libraryName}", e)
+                    -1L
+                }
+                moduleLoadNs[module] = loadNs
+                if (loadNs >= 0) {
+                    Log.d(TAG, "Native module ${module.libraryName} loaded in ${loadNs / 1000}us")
+                }
+                return loadNs >= 0
+            }
+        }
+
+        /**
+         * 引导库和已加载模块的加载耗时与常驻内存
+         */
+        fun nativeFootprint(): List<NativeLibraryFootprint> {
+            if (!isNativeLibraryLoaded) {
+                return emptyList()
+            }
+            val loaded = mutableListOf(BOOTSTRAP_LIBRARY to bootstrapLoadNs)
+            NativeModule.values().forEach { module ->
+                val loadNs = moduleLoadNs[module] ?: return@forEach
+                if (loadNs >= 0) {
+                    loaded.add(module.libraryName to loadNs)
+                }
+            }
+            val rssKb = nativeGetLibraryRss(loaded.map { it.first }.toTypedArray())
+            return loaded.mapIndexed { index, (name, loadNs) ->
+                NativeLibraryFootprint(name, loadNs / 1000, rssKb.getOrElse(index) { -1L })
+            }
+        }
+
         /**
          * 初始化（内部使用）
          */
@@ -69,6 +470,7 @@ class NativeSecurityDetector {
             }
             try {
                 initAntiHook(context)
+                nativeInitBaselineStore(File(context.filesDir, BASELINE_FILE).absolutePath)
                 isInitialized = true
                 Log.d(TAG, "Anti-hook protection initialized")
             } catch (e: Exception) {
@@ -77,10 +479,17 @@ class NativeSecurityDetector {
         }
     }
 
+    /**
+     * 模块中的检测只在扫描配置需要该模块时执行，模块在此时才加载
+     */
+    private inline fun withModule(profile: ScanProfile, module: NativeModule, check: () -> Boolean): Boolean {
+        return module in profile.nativeModules && ensureModule(module) && check()
+    }
+
     /**
      * 执行 Native 层检测
      */
-    fun performNativeDetection(context: Context): List<DetectionItem> {
+    fun performNativeDetection(context: Context, profile: ScanProfile = ScanProfile.FULL): List<DetectionItem> {
         val results = mutableListOf<DetectionItem>()
 
         if (!isNativeLibraryLoaded) {
@@ -92,6 +501,9 @@ class NativeSecurityDetector {
         initialize(context)
 
         try {
+            // 本轮扫描在当前线程的上下文中共享同一份 procfs 快照
+            nativeBeginScan()
+
             // Root 检测
             if (nativeCheckRoot()) {
                 results.add(
@@ -135,12 +547,221 @@ class NativeSecurityDetector {
                         type = DetectionType.EMULATOR,
                         description = "Emulator detected by native layer",
                         isAbnormal = true,
+                        details = mapOf(
+                            "source" to "native",
+                            // 模拟器检测中已经测过，直接取那次的结果
+                            "timingProfile" to nativeGetScanFinding("timing").orEmpty()
+                        )
+                    )
+                )
+            }
+
+            // 挂载命名空间检测
+            if (withModule(profile, NativeModule.SANDBOX) { nativeCheckMountNamespace() }) {
+                results.add(
+                    DetectionItem(
+                        type = DetectionType.ROOT,
+                        description = "Mount namespace tampering detected by native layer",
+                        isAbnormal = true,
+                        details = mapOf("source" to "native")
+                    )
+                )
+            }
+
+            // 虚拟环境检测（容器、云手机）
+            if (withModule(profile, NativeModule.SANDBOX) { nativeCheckVirtualEnvironment() }) {
+                results.add(
+                    DetectionItem(
+                        type = DetectionType.VIRTUAL_MACHINE,
+                        description = "Container or virtualized environment detected by native layer",
+                        isAbnormal = true,
+                        details = mapOf("source" to "native")
+                    )
+                )
+            }
+
+            // 多开/虚拟应用检测
+            val appInfo = context.applicationInfo
+            if (withModule(profile, NativeModule.SANDBOX) { nativeCheckVirtualApp(context.packageName, appInfo.dataDir, appInfo.uid) }) {
+                results.add(
+                    DetectionItem(
+                        type = DetectionType.VIRTUAL_MACHINE,
+                        description = "App running inside a virtual app / multi-instance host",
+                        isAbnormal = true,
+                        details = mapOf("source" to "native")
+                    )
+                )
+            }
+
+            // 链接器视图一致性检测
+            if (withModule(profile, NativeModule.MEMORY) { nativeCheckLinkerConsistency() }) {
+                results.add(
+                    DetectionItem(
+                        type = DetectionType.HOOK_ZYGISK,
+                        description = "Code mapped outside the linker's view detected by native layer",
+                        isAbnormal = true,
+                        details = mapOf("source" to "native")
+                    )
+                )
+            }
+
+            // 隐藏内存区域探测
+            if (withModule(profile, NativeModule.MEMORY) { nativeProbeHiddenRegions() }) {
+                results.add(
+                    DetectionItem(
+                        type = DetectionType.HOOK_FRIDA,
+                        description = "Memory hidden from /proc/self/maps detected by native layer",
+                        isAbnormal = true,
+                        details = mapOf("source" to "native")
+                    )
+                )
+            }
+
+            // 映射视图一致性检测
+            if (withModule(profile, NativeModule.MEMORY) { nativeCheckMapsConsistency() }) {
+                results.add(
+                    DetectionItem(
+                        type = DetectionType.HOOK_FRIDA,
+                        description = "Sanitized memory map views detected by native layer",
+                        isAbnormal = true,
+                        details = mapOf("source" to "native")
+                    )
+                )
+            }
+
+            // 代码页篡改检测（inline Hook）
+            if (withModule(profile, NativeModule.MEMORY) { nativeCheckDirtyCodePages() }) {
+                results.add(
+                    DetectionItem(
+                        type = DetectionType.HOOK_FRIDA,
+                        description = "Modified code pages detected by native layer",
+                        isAbnormal = true,
+                        details = mapOf("source" to "native")
+                    )
+                )
+            }
+
+            // ArtMethod 入口检测（LSPosed/Pine 等 ART Hook）
+            val artMethods = sensitiveMethods + packageManagerMethods(context)
+            if (withModule(profile, NativeModule.MEMORY) { nativeCheckArtMethods(artMethods) }) {
+                results.add(
+                    DetectionItem(
+                        type = DetectionType.HOOK_LSPOSED,
+                        description = "Hooked Java method entry points detected by native layer",
+                        isAbnormal = true,
+                        details = mapOf("source" to "native")
+                    )
+                )
+            }
+
+            // 软件断点检测（隐藏 TracerPid 的调试器）
+            if (nativeCheckCodeBreakpoints()) {
+                results.add(
+                    DetectionItem(
+                        type = DetectionType.DEBUGGABLE,
+                        description = "Software breakpoints in native code detected by native layer",
+                        isAbnormal = true,
+                        details = mapOf("source" to "native")
+                    )
+                )
+            }
+
+            // 信号处理函数审计
+            if (nativeCheckSignalHandlers()) {
+                results.add(
+                    DetectionItem(
+                        type = DetectionType.HOOK_FRIDA,
+                        description = "Signal handlers from injected code detected by native layer",
+                        isAbnormal = true,
+                        details = mapOf("source" to "native")
+                    )
+                )
+            }
+
+            // 进程血缘检测
+            if (withModule(profile, NativeModule.SANDBOX) { nativeCheckProcessLineage() }) {
+                results.add(
+                    DetectionItem(
+                        type = DetectionType.DEBUGGABLE,
+                        description = "Process spawned outside zygote detected by native layer",
+                        isAbnormal = true,
                         details = mapOf("source" to "native")
                     )
                 )
             }
 
+            // 文件描述符分类检测
+            if (withModule(profile, NativeModule.IPC) { nativeCheckFileDescriptors() }) {
+                results.add(
+                    DetectionItem(
+                        type = DetectionType.HOOK_FRIDA,
+                        description = "Injector file descriptors detected by native layer",
+                        isAbnormal = true,
+                        details = mapOf("source" to "native")
+                    )
+                )
+            }
+
+            // 本机 D-Bus 服务探测（任意端口的 frida-server）
+            if (withModule(profile, NativeModule.IPC) { nativeProbeDbusListeners() }) {
+                results.add(
+                    DetectionItem(
+                        type = DetectionType.HOOK_FRIDA,
+                        description = "Frida server (D-Bus) listening locally detected by native layer",
+                        isAbnormal = true,
+                        details = mapOf("source" to "native")
+                    )
+                )
+            }
+
+            // 热点函数调用延迟指纹（Hook 带来的额外开销）
+            if (withModule(profile, NativeModule.MEMORY) { nativeCheckCallLatency() }) {
+                results.add(
+                    DetectionItem(
+                        type = DetectionType.HOOK_FRIDA,
+                        description = "Instrumentation latency on hot libc/JNI calls detected by native layer",
+                        isAbnormal = true,
+                        details = mapOf("source" to "native")
+                    )
+                )
+            }
+
+            // 库加载时基线（早于 Java 层初始化的注入和调试）
+            if (nativeCheckEarlyStage()) {
+                results.add(
+                    DetectionItem(
+                        type = DetectionType.HOOK_FRIDA,
+                        description = "Injection or tracer present before Java initialization detected by native layer",
+                        isAbnormal = true,
+                        details = mapOf("source" to "native")
+                    )
+                )
+            }
+
+            // 后台监控在两次扫描之间发现的风险（注入后又清理痕迹的情况单次扫描看不到）
+            val monitorRisks = monitorRisks()
+            if (monitorRisks.isNotEmpty()) {
+                results.add(
+                    DetectionItem(
+                        type = DetectionType.HOOK_FRIDA,
+                        description = "Runtime tampering observed by background monitor",
+                        isAbnormal = true,
+                        details = mapOf(
+                            "source" to "native",
+                            "checks" to monitorRisks.joinToString(", ")
+                        )
+                    )
+                )
+            }
+
+            nativeEndScan().forEach { finding -> Log.d(TAG, "Native finding: $finding") }
             Log.d(TAG, "Native detection completed: ${results.size} issues found")
+            // 开销统计要遍历整份 smaps，只在可调试构建中记录
+            if ((context.applicationInfo.flags and ApplicationInfo.FLAG_DEBUGGABLE) != 0) {
+                nativeFootprint().forEach { library ->
+                    Log.d(TAG, "Native library ${library.name}: load ${library.loadTimeUs}us, rss ${library.rssKb}kB")
+                }
+            }
         } catch (e: Exception) {
             Log.e(TAG, "Native detection error", e)
             results.add(
@@ -156,3 +777,26 @@ class NativeSecurityDetector {
         return results
     }
 }
+
+/**
+ * 按需加载的 native 扫描模块，均依赖引导库 libsecurity_native.so
+ */
+enum class NativeModule(val libraryName: String) {
+    // 内存完整性：链接器视图、隐藏区域、映射视图、代码页、ArtMethod、调用延迟
+    MEMORY("scanner_memory"),
+
+    // 沙箱与虚拟化：挂载/命名空间、多开、进程血缘
+    SANDBOX("scanner_sandbox"),
+
+    // 套接字与文件描述符：fd 分类、D-Bus 监听
+    IPC("scanner_ipc")
+}
+
+/**
+ * 单个 native 库的开销
+ */
+data class NativeLibraryFootprint(
+    val name: String,
+    val loadTimeUs: Long,
+    val rssKb: Long
+)
@@ -12,6 +12,11 @@ import java.io.InputStreamReader
  */
 class RootDetector(private val context: Context) : IDetector {
 
+    companion object {
+        // 设备历史不足时的 bind mount 回退阈值，正常设备通常少于 20 个
+        private const val BIND_MOUNT_THRESHOLD = 50
+    }
+
     override suspend fun detect(): List<DetectionItem> {
         val results = mutableListOf<DetectionItem>()
 
@@ -285,15 +290,19 @@ class RootDetector(private val context: Context) : IDetector {
             process.waitFor()
 
             // Magisk 的典型特征：大量的 bind mount
+            // 各 ROM 的正常数量差别很大，和本设备的历史比较；历史不足时才用固定阈值
             val bindMountCount = mountInfo.split("\n").count { it.contains("bind") }
-            if (bindMountCount > 50) { // 正常设备通常少于 20 个
+            if (NativeSecurityDetector.isCountAbnormal(
+                    context, NativeSecurityDetector.METRIC_BIND_MOUNTS, bindMountCount, BIND_MOUNT_THRESHOLD
+                )
+            ) {
                 return DetectionItem(
                     type = DetectionType.ROOT,
                     description = "Abnormal mount namespace detected",
                     isAbnormal = true,
                     details = mapOf(
                         "bind_mount_count" to bindMountCount.toString(),
-                        "threshold" to "50"
+                        "fallback_threshold" to BIND_MOUNT_THRESHOLD.toString()
                     )
                 )
             }
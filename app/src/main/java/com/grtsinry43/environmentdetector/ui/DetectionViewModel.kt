@@ -5,6 +5,7 @@ import androidx.lifecycle.AndroidViewModel
 import androidx.lifecycle.viewModelScope
 import com.grtsinry43.environmentdetector.security.DetectionResult
 import com.grtsinry43.environmentdetector.security.EnvironmentDetector
+import com.grtsinry43.environmentdetector.security.NativeSecurityDetector
 import kotlinx.coroutines.flow.MutableStateFlow
 import kotlinx.coroutines.flow.StateFlow
 import kotlinx.coroutines.flow.asStateFlow
@@ -20,6 +21,11 @@ class DetectionViewModel(application: Application) : AndroidViewModel(applicatio
     private val _uiState = MutableStateFlow<DetectionUiState>(DetectionUiState.Idle)
     val uiState: StateFlow<DetectionUiState> = _uiState.asStateFlow()
 
+    init {
+        // Background monitoring runs while the detection screen is alive; its risks show up in full scans
+        NativeSecurityDetector.startBackgroundMonitor(application)
+    }
+
     /**
      * Start full detection
      */
@@ -56,6 +62,11 @@ class DetectionViewModel(application: Application) : AndroidViewModel(applicatio
     fun reset() {
         _uiState.value = DetectionUiState.Idle
     }
+
+    override fun onCleared() {
+        NativeSecurityDetector.stopBackgroundMonitor()
+        super.onCleared()
+    }
 }
 
 /**
@@ -0,0 +1,115 @@
+package com.grtsinry43.environmentdetector.security
+
+import kotlinx.coroutines.CompletableDeferred
+import kotlinx.coroutines.CoroutineStart
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.SupervisorJob
+import kotlinx.coroutines.async
+import kotlinx.coroutines.awaitAll
+import kotlinx.coroutines.cancel
+import kotlinx.coroutines.runBlocking
+import kotlinx.coroutines.withTimeout
+import org.junit.After
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertSame
+import org.junit.Test
+import java.util.concurrent.atomic.AtomicInteger
+
+/**
+ * EnvironmentDetector 的单飞：并发调用只执行一次扫描，maxAgeMs 时间窗内复用上一次结果
+ */
+class ScanSingleFlightTest {
+
+    private val scope = CoroutineScope(SupervisorJob() + Dispatchers.Default)
+    private val scanCount = AtomicInteger()
+    private val finishedCount = AtomicInteger()
+    private val singleFlight = ScanSingleFlight(scope) { finishedCount.incrementAndGet() }
+
+    @After
+    fun tearDown() {
+        scope.cancel()
+    }
+
+    private fun result() = DetectionResult(
+        isClean = true,
+        detectionItems = emptyList(),
+        timestamp = System.currentTimeMillis(),
+        detectionTimeMs = 0
+    )
+
+    @Test
+    fun concurrentCallersShareOneScan() = runBlocking {
+        val callers = 16
+        val entered = CompletableDeferred<Unit>()
+        val release = CompletableDeferred<Unit>()
+        val expected = result()
+
+        val first = scope.async {
+            singleFlight.run(ScanProfile.FULL, 0) {
+                scanCount.incrementAndGet()
+                entered.complete(Unit)
+                release.await()
+                expected
+            }
+        }
+        // 扫描开始后再发起其余调用；UNDISPATCHED 让每个调用在放行扫描前就已挂起在进行中的扫描上
+        withTimeout(5_000) { entered.await() }
+        val joiners = (1 until callers).map {
+            async(start = CoroutineStart.UNDISPATCHED) {
+                singleFlight.run(ScanProfile.FULL, 0) {
+                    scanCount.incrementAndGet()
+                    result()
+                }
+            }
+        }
+        release.complete(Unit)
+
+        val results = withTimeout(5_000) { (joiners + first).awaitAll() }
+        assertEquals(1, scanCount.get())
+        assertEquals(1, finishedCount.get())
+        results.forEach { assertSame(expected, it) }
+    }
+
+    @Test
+    fun recentResultIsReusedWithinMaxAge() = runBlocking {
+        val first = singleFlight.run(ScanProfile.QUICK, 60_000) {
+            scanCount.incrementAndGet()
+            result()
+        }
+        val second = singleFlight.run(ScanProfile.QUICK, 60_000) {
+            scanCount.incrementAndGet()
+            result()
+        }
+
+        assertEquals(1, scanCount.get())
+        assertSame(first, second)
+    }
+
+    @Test
+    fun finishedScanIsRerunWithoutMaxAge() = runBlocking {
+        repeat(2) {
+            singleFlight.run(ScanProfile.QUICK, 0) {
+                scanCount.incrementAndGet()
+                result()
+            }
+        }
+
+        assertEquals(2, scanCount.get())
+        assertEquals(2, finishedCount.get())
+    }
+
+    @Test
+    fun profilesDoNotShareResults() = runBlocking {
+        singleFlight.run(ScanProfile.QUICK, 60_000) {
+            scanCount.incrementAndGet()
+            result()
+        }
+        singleFlight.run(ScanProfile.FULL, 60_000) {
+            scanCount.incrementAndGet()
+            result()
+        }
+
+        assertEquals(2, scanCount.get())
+    }
+}